@@ -1,70 +1,94 @@
 #include "algorithm.hpp"
 
 #include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 #include "definitions.hpp"
+#include "permutation.hpp"
 
 namespace mc {
 
-Algorithm::Algorithm(const Permutation& permutation)
+template <typename Index>
+BasicAlgorithm<Index>::BasicAlgorithm(const Permutation& permutation)
     : permutation{permutation} {
+  if (permutation.size() + 1U > maxLength())
+    throw std::length_error("Algorithm: chain too long for the index type");
   buildTree();
 }
 
-double Algorithm::computeFlops(const Instance& instance) {
-  assignSizes(instance);
+template <typename Index>
+double BasicAlgorithm<Index>::computeFlops(const Instance& instance) {
+  return computeCost(instance, FlopsModel{});
+}
 
+double permutationFlops(const Permutation& permutation,
+                        const Instance& instance) {
   double flops = 0.0;
-  for (unsigned i = permutation.size() + 1; i < tree.size(); i++) {
-    propagateSizes(i);
-    flops += costMult(tree[tree[i].left]._rows, tree[tree[i].left]._cols,
-                      tree[tree[i].right]._cols);
-  }
-
+  visitOrder(permutation, instance.size() - 1U,
+             [&](unsigned, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+               flops += FlopsModel{}(instance[lo], instance[p], instance[hi]);
+             });
   return flops;
 }
 
-void Algorithm::buildTree() {
+template <typename Index>
+void BasicAlgorithm<Index>::buildTree() {
+  const unsigned n = permutation.size() + 1U;
   tree.reserve(2 * permutation.size() + 1);
   createInputNodes();
 
-  int8_t left, right;
+  // prev/next link the dimensions that are still alive; root[lo] is the node
+  // of the operand that starts at dimension lo. Multiplying at p joins the
+  // operands [prev[p], p] and [p, next[p]] and consumes dimension p.
+  std::vector<unsigned> prev(n + 1U), next(n + 1U);
+  std::vector<Index> root(n + 1U);
+  for (unsigned i = 0U; i <= n; i++) {
+    prev[i] = i - 1U;
+    next[i] = i + 1U;
+    root[i] = static_cast<Index>(i);
+  }
+
+  Index left, right;
   for (const auto& p : permutation) {
-    left = getRoot(p - 1);
-    right = getRoot(p);
+    if (p == 0U or p >= n or next[prev[p]] != p)
+      throw std::invalid_argument("Algorithm: invalid order of computation");
+    left = root[prev[p]];
+    right = root[p];
 
     tree.emplace_back(left, right);
 
     tree[left].parent = tree.size() - 1;
     tree[right].parent = tree.size() - 1;
+
+    root[prev[p]] = static_cast<Index>(tree.size() - 1);
+    next[prev[p]] = next[p];
+    prev[next[p]] = prev[p];
   }
 }
 
-void Algorithm::createInputNodes() {
+template <typename Index>
+void BasicAlgorithm<Index>::createInputNodes() {
   for (unsigned i = 0U; i < permutation.size() + 1; i++) tree.emplace_back();
 }
 
-int8_t Algorithm::getRoot(const int8_t id) const {
-  return (tree[id].parent == -1) ? id : getRoot(tree[id].parent);
-}
-
-void Algorithm::assignSizes(const Instance& instance) {
+template <typename Index>
+void BasicAlgorithm<Index>::assignSizes(const Instance& instance) {
   for (unsigned i = 0U; i <= permutation.size(); i++) {
     tree[i]._rows = instance[i];
     tree[i]._cols = instance[i + 1];
   }
 }
 
-void Algorithm::propagateSizes(const int8_t id) {
+template <typename Index>
+void BasicAlgorithm<Index>::propagateSizes(const Index id) {
   tree[id]._rows = tree[tree[id].left]._rows;
   tree[id]._cols = tree[tree[id].right]._cols;
 }
 
-double Algorithm::costMult(const unsigned m, const unsigned k,
-                           const unsigned n) const {
-  return static_cast<double>(m) * static_cast<double>(k) *
-         static_cast<double>(n);
-}
+template class BasicAlgorithm<int8_t>;
+template class BasicAlgorithm<int16_t>;
+template class BasicAlgorithm<int32_t>;
 
 }  // namespace mc
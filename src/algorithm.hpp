@@ -2,39 +2,58 @@
 #define ALGORITHM_H
 
 #include <cstdint>
+#include <limits>
 #include <vector>
 
+#include "cost_models.hpp"
 #include "definitions.hpp"
 
 namespace mc {
 
-class Node {
+// Index is the signed integer type of the node IDs. A tree for a chain of
+// length n has 2n-1 nodes, so int8_t (densest, the default) covers chains of
+// up to 64 matrices, int16_t up to 16384 and int32_t up to 2^30.
+template <typename Index>
+class BasicNode {
  public:
   unsigned _rows{}, _cols{};
-  int8_t left{-1}, right{-1}, parent{-1};
+  Index left{-1}, right{-1}, parent{-1};
 
   // Default Constructor. Constructor for input nodes.
-  Node() = default;
+  BasicNode() = default;
 
-  Node(const int8_t left, const int8_t right) : left{left}, right{right} {}
+  BasicNode(const Index left, const Index right) : left{left}, right{right} {}
 };
 
-class Algorithm {  // An algorithm is a parenthesisation.
+template <typename Index>
+class BasicAlgorithm {  // An algorithm is a parenthesisation.
  private:
   Permutation permutation;  // Order of computation for the algorithm.
-  std::vector<Node> tree;   // Proper in-memory representation of the algorithm.
+  std::vector<BasicNode<Index>> tree;  // Proper in-memory representation of
+                                       // the algorithm.
 
  public:
-  Algorithm() = delete;
+  BasicAlgorithm() = delete;
 
   /**
    * @brief Parametrised constructor taking in a permutation.
    *
+   * Throws std::length_error if the tree does not fit in Index, and
+   * std::invalid_argument if the permutation is not an order of computation.
+   *
    * @param permutation vector<unsigned>.
    */
-  Algorithm(const Permutation& permutation);
+  BasicAlgorithm(const Permutation& permutation);
 
-  ~Algorithm() = default;
+  ~BasicAlgorithm() = default;
+
+  /**
+   * @brief Returns the maximum length of the chain an Index can represent.
+   */
+  static constexpr unsigned maxLength() noexcept {
+    return (static_cast<unsigned>(std::numeric_limits<Index>::max()) + 2U) /
+           2U;
+  }
 
   // Getter for the permutation.
   inline Permutation getPermutation() const noexcept { return permutation; }
@@ -47,6 +66,17 @@ class Algorithm {  // An algorithm is a parenthesisation.
    */
   double computeFlops(const Instance& instance);
 
+  /**
+   * @brief Returns the cost of the algorithm on the given instance, as
+   * measured by the passed cost model (see cost_models.hpp).
+   *
+   * @param instance  vector<unsigned>.
+   * @param model     cost model, called once per multiplication with (m,k,n).
+   * @return double   accumulated cost.
+   */
+  template <typename CostModel>
+  double computeCost(const Instance& instance, const CostModel& model);
+
  private:
   /**
    * @brief Does the actual work when constructing the Algorithm.
@@ -59,14 +89,6 @@ class Algorithm {  // An algorithm is a parenthesisation.
    */
   void createInputNodes();
 
-  /**
-   * @brief Returns the topmost node's ID of the node whose ID is passed.
-   *
-   * @param id      int8_t - index of the node in the tree vector.
-   * @return int8_t topmost node's ID.
-   */
-  int8_t getRoot(const int8_t id) const;
-
   /**
    * @brief Assigns sizes in the instance to the input nodes.
    *
@@ -77,22 +99,48 @@ class Algorithm {  // An algorithm is a parenthesisation.
   /**
    * @brief Propagates the sizes for the node with the passed ID.
    *
-   * @param id  int8_t - ID of the node to which sizes are propagated.
+   * @param id  Index - ID of the node to which sizes are propagated.
    */
-  void propagateSizes(const int8_t id);
-
-  /**
-   * @brief Returns the cost of a multiplication of two matrices with sizes
-   * (m,k,n). For the purpose of this work: costMult(m,k,n) = m * k * n.
-   *
-   * @param m       unsigned - number of rows of the left matrix.
-   * @param k       unsigned - number of columns of the left matrix.
-   * @param n       unsigned - number of columns of the right matrix.
-   * @return double cost of the multiplication.
-   */
-  double costMult(const unsigned m, const unsigned k, const unsigned n) const;
+  void propagateSizes(const Index id);
 };
 
+using Node = BasicNode<int8_t>;
+using Algorithm = BasicAlgorithm<int8_t>;
+using Algorithm16 = BasicAlgorithm<int16_t>;
+using Algorithm32 = BasicAlgorithm<int32_t>;
+
+/**
+ * @brief Returns the number of FLOPs of the order of computation on the given
+ * instance, without building an Algorithm.
+ *
+ * Runs in O(n) time and memory by keeping the dimensions that are still
+ * alive in a linked list (see visitOrder), so it works for chains of any
+ * length. The order needs not be canonical. Throws std::invalid_argument if
+ * it is not an order of computation for the instance.
+ *
+ * @param permutation order of computation.
+ * @param instance    vector<unsigned>.
+ * @return double     number of FLOPs.
+ */
+double permutationFlops(const Permutation& permutation,
+                        const Instance& instance);
+
+template <typename Index>
+template <typename CostModel>
+double BasicAlgorithm<Index>::computeCost(const Instance& instance,
+                                          const CostModel& model) {
+  assignSizes(instance);
+
+  double cost = 0.0;
+  for (unsigned i = permutation.size() + 1; i < tree.size(); i++) {
+    propagateSizes(i);
+    cost += model(tree[tree[i].left]._rows, tree[tree[i].left]._cols,
+                  tree[tree[i].right]._cols);
+  }
+
+  return cost;
+}
+
 }  // namespace mc
 
 #endif
\ No newline at end of file
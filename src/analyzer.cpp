@@ -1,12 +1,59 @@
 #include "analyzer.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <set>
 #include <vector>
 
+#include "executor.hpp"
+#include "makespan.hpp"
+
 namespace mc {
 
+void PenaltyStats::add(const double penalty) {
+  n++;
+  const double delta = penalty - mean;
+  mean += delta / n;
+  m2 += delta * (penalty - mean);
+
+  if (penalty > 0.0) {
+    nnz++;
+    if (penalty > max_penalty) max_penalty = penalty;
+  }
+}
+
+void PenaltyStats::add(const std::vector<double>& penalties) {
+  for (const auto& penalty : penalties) add(penalty);
+}
+
+double PenaltyStats::avgHalfWidth(const double z) const {
+  if (n < 2U) return std::numeric_limits<double>::infinity();
+  return z * std::sqrt(m2 / (n - 1U) / n);
+}
+
+std::pair<double, double> PenaltyStats::freqInterval(const double z) const {
+  if (n == 0U) return {0.0, 1.0};
+  const double p = freqPenalty(), z2_n = z * z / n;
+  const double center = (p + z2_n / 2.0) / (1.0 + z2_n);
+  const double half = z / (1.0 + z2_n) *
+                      std::sqrt(p * (1.0 - p) / n + z2_n / (4.0 * n));
+  return {std::max(0.0, center - half), std::min(1.0, center + half)};
+}
+
+double PenaltyStats::freqHalfWidth(const double z) const {
+  const auto [lo, hi] = freqInterval(z);
+  return (hi - lo) / 2.0;
+}
+
+bool PenaltyStats::converged(const double z, const double tolerance,
+                             const unsigned long long min_nonzero) const {
+  return nnz >= min_nonzero and avgHalfWidth(z) <= tolerance and
+         freqHalfWidth(z) <= tolerance;
+}
+
 Analyzer::Analyzer() {
   std::random_device rd;
   random_generator = std::mt19937(rd());
@@ -45,16 +92,24 @@ std::map<Permutation, unsigned> getMapPerm2Index(
 
 std::vector<double> FLOPsOnInstances(std::vector<Algorithm>& A,
                                      const std::vector<Instance>& S) {
+  return CostOnInstances(A, S, FlopsModel{});
+}
+
+std::vector<double> TimesOnInstances(const std::vector<Algorithm>& A,
+                                     const std::vector<Instance>& S,
+                                     const unsigned n_reps,
+                                     const unsigned n_threads) {
   const unsigned M = A.size();
   const unsigned N = S.size();
-  std::vector<double> cost_matrix(M * N);
+  std::vector<double> time_matrix(M * N);
 
   for (unsigned j = 0U; j < N; j++) {
+    Executor executor(S[j], n_threads);
     for (unsigned i = 0U; i < M; i++) {
-      cost_matrix[j * M + i] = A[i].computeFlops(S[j]);
+      time_matrix[j * M + i] = executor.measure(A[i].getPermutation(), n_reps);
     }
   }
-  return cost_matrix;
+  return time_matrix;
 }
 
 std::vector<double> getMinA(const unsigned M, const unsigned N,
@@ -68,6 +123,26 @@ std::vector<double> getMinA(const unsigned M, const unsigned N,
   return min_A;
 }
 
+std::vector<unsigned> getArgMinA(const unsigned M, const unsigned N,
+                                 const std::vector<double>& cost_matrix) {
+  std::vector<unsigned> argmin_A(N, 0U);
+  for (unsigned j = 0; j < N; j++) {
+    for (unsigned i = 1; i < M; i++) {
+      if (cost_matrix[j * M + i] < cost_matrix[j * M + argmin_A[j]])
+        argmin_A[j] = i;
+    }
+  }
+  return argmin_A;
+}
+
+std::vector<double> getCostFromIDs(const unsigned M, const unsigned N,
+                                   const std::vector<double>& cost_matrix,
+                                   const std::vector<unsigned>& IDs) {
+  std::vector<double> cost_IDs(N);
+  for (unsigned j = 0; j < N; j++) cost_IDs[j] = cost_matrix[j * M + IDs[j]];
+  return cost_IDs;
+}
+
 std::vector<double> getMinZ(const unsigned M, const unsigned N,
                             const std::vector<double>& cost_matrix,
                             const std::set<unsigned>& Z) {
@@ -81,6 +156,144 @@ std::vector<double> getMinZ(const unsigned M, const unsigned N,
   return min_Z;
 }
 
+namespace {
+
+// Transposes the instances in S so that K[i * N + j] = S[j][i], and computes
+// x[j], the sum of the products of adjacent dimensions (cyclically).
+void transposeInstances(const std::vector<Instance>& S,
+                        std::vector<double>& K, std::vector<double>& x) {
+  const unsigned N = S.size();
+  const unsigned n_dims = N ? S[0].size() : 0U;
+  K.resize(n_dims * N);
+  for (unsigned j = 0U; j < N; j++) {
+    for (unsigned i = 0U; i < n_dims; i++) K[i * N + j] = S[j][i];
+  }
+
+  const double* k_n = &K[(n_dims - 1U) * N];
+  x.assign(N, 0.0);
+  for (unsigned j = 0U; j < N; j++) x[j] = K[j] * k_n[j];
+  for (unsigned i = 1U; i < n_dims; i++) {
+    const double* k_prev = &K[(i - 1U) * N];
+    const double* k_i = &K[i * N];
+    for (unsigned j = 0U; j < N; j++) x[j] += k_prev[j] * k_i[j];
+  }
+}
+
+// Cost of the essential fanning out from h for all instances, into t.
+void essentialRow(const unsigned h, const unsigned n_dims, const unsigned N,
+                  const std::vector<double>& K, const std::vector<double>& x,
+                  std::vector<double>& t) {
+  const double* k_h = &K[h * N];
+  const double* k_l = &K[((h == 0U) ? n_dims - 1U : h - 1U) * N];
+  const double* k_r = &K[((h == n_dims - 1U) ? 0U : h + 1U) * N];
+  for (unsigned j = 0U; j < N; j++)
+    t[j] = k_h[j] * (x[j] - k_l[j] * k_h[j] - k_h[j] * k_r[j]);
+}
+
+}  // namespace
+
+std::vector<double> getEssentialCosts(const std::vector<Instance>& S) {
+  const unsigned N = S.size();
+  const unsigned n_dims = N ? S[0].size() : 0U;
+  std::vector<double> K, x, t(N);
+  std::vector<double> essential_costs(n_dims * N);
+  if (N == 0U) return essential_costs;
+
+  transposeInstances(S, K, x);
+  for (unsigned h = 0U; h < n_dims; h++) {
+    essentialRow(h, n_dims, N, K, x, t);
+    for (unsigned j = 0U; j < N; j++) essential_costs[j * n_dims + h] = t[j];
+  }
+  return essential_costs;
+}
+
+std::vector<double> getMinEssentials(const std::vector<Instance>& S) {
+  const unsigned N = S.size();
+  const unsigned n_dims = N ? S[0].size() : 0U;
+  std::vector<double> K, x, t(N);
+  std::vector<double> min_E(N, std::numeric_limits<double>::max());
+  if (N == 0U) return min_E;
+
+  transposeInstances(S, K, x);
+  for (unsigned h = 0U; h < n_dims; h++) {
+    essentialRow(h, n_dims, N, K, x, t);
+    for (unsigned j = 0U; j < N; j++) min_E[j] = std::min(min_E[j], t[j]);
+  }
+  return min_E;
+}
+
+CostReduction reduceCostMatrix(const unsigned M, const unsigned N,
+                               const std::vector<double>& cost_matrix,
+                               const std::vector<std::set<unsigned>>& Zs,
+                               const std::vector<std::vector<unsigned>>& IDs) {
+  constexpr unsigned lanes = 8U;
+  constexpr unsigned block = 4096U;  // Doubles per block: 32 KiB.
+  constexpr double inf = std::numeric_limits<double>::max();
+
+  CostReduction result;
+  result.min_A.resize(N);
+  result.argmin_A.resize(N);
+  result.min_Z.assign(Zs.size(), std::vector<double>(N, inf));
+  result.cost_IDs.assign(IDs.size(), std::vector<double>(N));
+
+  // Subsets as sorted arrays, consumed block by block.
+  std::vector<std::vector<unsigned>> sorted_Zs;
+  for (const auto& Z : Zs) sorted_Zs.emplace_back(Z.begin(), Z.end());
+  std::vector<unsigned> next_Z(Zs.size());
+
+  for (unsigned j = 0U; j < N; j++) {
+    const double* row = &cost_matrix[static_cast<size_t>(j) * M];
+    double lane_min[lanes];
+    unsigned lane_arg[lanes];
+    for (unsigned l = 0U; l < lanes; l++) {
+      lane_min[l] = inf;
+      lane_arg[l] = 0U;
+    }
+    std::fill(next_Z.begin(), next_Z.end(), 0U);
+
+    for (unsigned b = 0U; b < M; b += block) {
+      const unsigned b_end = std::min(b + block, M);
+
+      unsigned i = b;
+      for (; i + lanes <= b_end; i += lanes) {
+        for (unsigned l = 0U; l < lanes; l++) {
+          const bool less = row[i + l] < lane_min[l];
+          lane_min[l] = less ? row[i + l] : lane_min[l];
+          lane_arg[l] = less ? i + l : lane_arg[l];
+        }
+      }
+      for (; i < b_end; i++) {
+        if (row[i] < lane_min[0]) {
+          lane_min[0] = row[i];
+          lane_arg[0] = i;
+        }
+      }
+
+      for (unsigned z = 0U; z < sorted_Zs.size(); z++) {
+        double m = result.min_Z[z][j];
+        unsigned& k = next_Z[z];
+        for (; k < sorted_Zs[z].size() and sorted_Zs[z][k] < b_end; k++)
+          m = std::min(m, row[sorted_Zs[z][k]]);
+        result.min_Z[z][j] = m;
+      }
+    }
+
+    // Reduce the lanes; ties go to the lowest index, as in getArgMinA.
+    unsigned best = 0U;
+    for (unsigned l = 1U; l < lanes; l++) {
+      if (lane_min[l] < lane_min[best] or
+          (lane_min[l] == lane_min[best] and lane_arg[l] < lane_arg[best]))
+        best = l;
+    }
+    result.min_A[j] = lane_min[best];
+    result.argmin_A[j] = lane_arg[best];
+
+    for (unsigned a = 0U; a < IDs.size(); a++)
+      result.cost_IDs[a][j] = row[IDs[a][j]];
+  }
+  return result;
+}
+
 double penalty(const double min_A, const double min_Z) {
   return (min_Z / min_A) - 1.0;
 }
@@ -120,6 +333,45 @@ void printMetrics(const std::vector<double>& penalty_Z,
             << "================================================\n\n";
 }
 
+void printMetrics(const PenaltyStats& stats, const std::string name_exp,
+                  const double z) {
+  std::cout << "================================================\n"
+            << name_exp << '\n'
+            << "================================================\n"
+            << "max_penalty: " << stats.maxPenalty() << "\n"
+            << "freq_penalty: " << stats.freqPenalty() << " in ["
+            << stats.freqInterval(z).first << ", "
+            << stats.freqInterval(z).second << "]\n"
+            << "avg_penalty: " << stats.avgPenalty() << " +- "
+            << stats.avgHalfWidth(z) << " (" << stats.countNonZero()
+            << " non-zero)\n"
+            << "avg_penalty (only non-zero): " << stats.avgNonZero() << "\n"
+            << "================================================\n\n";
+}
+
+void printSavings(const std::vector<double>& saving,
+                  const std::string name_exp) {
+  const double N = static_cast<double>(saving.size());
+  double max_saving = 0.0, nnz = 0.0, avg_saving = 0.0;
+  for (const auto& x : saving) {
+    if (x > 0.0) {
+      nnz += 1.0;
+      avg_saving += x;
+      max_saving = std::max(max_saving, x);
+    }
+  }
+
+  std::cout << "================================================\n"
+            << name_exp << '\n'
+            << "================================================\n"
+            << "max_saving: " << max_saving << "\n"
+            << "freq_saving: " << nnz / N << "\n"
+            << "avg_saving: " << avg_saving / N << "\n"
+            << "avg_saving (only non-zero): "
+            << (nnz > 0.0 ? avg_saving / nnz : 0.0) << "\n"
+            << "================================================\n\n";
+}
+
 Permutation getPermFromApprx(
     const Instance& instance,
     std::function<Permutation(const Instance&)> apprx) {
@@ -135,6 +387,15 @@ std::vector<Permutation> getPermFromApprx(
   return perms;
 }
 
+std::vector<unsigned> getIDsFromApprx(
+    const std::vector<Instance>& S,
+    const std::map<Permutation, unsigned>& perm2index,
+    std::function<Permutation(const Instance&)> apprx) {
+  std::vector<unsigned> IDs(S.size());
+  for (unsigned j = 0; j < S.size(); j++) IDs[j] = perm2index.at(apprx(S[j]));
+  return IDs;
+}
+
 std::vector<double> getCostFromApprx(
     std::vector<Algorithm>& A, const std::vector<Instance>& S,
     const std::vector<double>& cost_matrix,
@@ -151,4 +412,23 @@ std::vector<double> getCostFromApprx(
   return cost_apprx;
 }
 
+std::vector<double> getMakespanFromApprx(
+    const std::vector<Instance>& S,
+    std::function<Permutation(const Instance&)> apprx,
+    const unsigned n_workers) {
+  std::vector<double> makespans(S.size());
+  for (unsigned j = 0; j < S.size(); j++)
+    makespans[j] = listMakespan(apprx(S[j]), S[j], n_workers);
+  return makespans;
+}
+
+std::vector<double> getCriticalPathFromApprx(
+    const std::vector<Instance>& S,
+    std::function<Permutation(const Instance&)> apprx) {
+  std::vector<double> paths(S.size());
+  for (unsigned j = 0; j < S.size(); j++)
+    paths[j] = criticalPath(apprx(S[j]), S[j]);
+  return paths;
+}
+
 }  // namespace mc
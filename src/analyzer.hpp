@@ -5,14 +5,100 @@
 #include <map>
 #include <random>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "algorithm.hpp"
 #include "apprx_algorithms.hpp"
+#include "cost_models.hpp"
 #include "definitions.hpp"
 
 namespace mc {
 
+struct CostReduction {  // Result of reduceCostMatrix.
+  std::vector<double> min_A;                   // Minimum per instance.
+  std::vector<unsigned> argmin_A;              // Its index per instance.
+  std::vector<std::vector<double>> min_Z;      // Per subset, min per instance.
+  std::vector<std::vector<double>> cost_IDs;   // Per selection, gathered cost.
+};
+
+// Non-zero penalties needed before the interval of avg_penalty is trusted:
+// with fewer, its variance is estimated from too few misses (none at all
+// gives an interval of width 0).
+constexpr unsigned default_min_nonzero = 30U;
+
+class PenaltyStats {  // Running metrics on penalties (Welford updates).
+ private:
+  unsigned long long n{0U}, nnz{0U};
+  double mean{0.0}, m2{0.0};  // Penalty.
+  double max_penalty{-1.0};
+
+ public:
+  PenaltyStats() = default;
+
+  /**
+   * @brief Adds the penalty of one instance.
+   *
+   * @param penalty penalty of the instance.
+   */
+  void add(const double penalty);
+
+  /**
+   * @brief Adds the penalties of a batch of instances.
+   *
+   * @param penalties vector of penalties, one per instance.
+   */
+  void add(const std::vector<double>& penalties);
+
+  /**
+   * @brief Returns the half-width of the (Wald) confidence interval for the
+   * average penalty, with z the quantile of the normal distribution (1.96 for
+   * 95%). Only meaningful with enough non-zero penalties (see converged).
+   */
+  double avgHalfWidth(const double z) const;
+
+  /**
+   * @brief Returns the Wilson score interval for the frequency of non-zero
+   * penalties. Unlike the Wald interval, it does not collapse to a point when
+   * no (or every) penalty is non-zero.
+   *
+   * @param z                           quantile of the normal distribution.
+   * @return std::pair<double, double>  lower and upper bounds.
+   */
+  std::pair<double, double> freqInterval(const double z) const;
+
+  /**
+   * @brief Returns the half-width of freqInterval.
+   */
+  double freqHalfWidth(const double z) const;
+
+  /**
+   * @brief Whether both intervals are within the tolerance, at least
+   * min_nonzero penalties being non-zero. An approximation that is never
+   * penalised thus never converges.
+   *
+   * @param z           quantile of the normal distribution.
+   * @param tolerance   maximum half-width of both intervals.
+   * @param min_nonzero minimum number of non-zero penalties.
+   * @return bool
+   */
+  bool converged(const double z, const double tolerance,
+                 const unsigned long long min_nonzero =
+                     default_min_nonzero) const;
+
+  // Getters for the metrics.
+  inline unsigned long long count() const noexcept { return n; }
+  inline unsigned long long countNonZero() const noexcept { return nnz; }
+  inline double maxPenalty() const noexcept { return max_penalty; }
+  inline double avgPenalty() const noexcept { return mean; }
+  inline double freqPenalty() const noexcept {
+    return (n == 0U) ? 0.0 : nnz / static_cast<double>(n);
+  }
+  inline double avgNonZero() const noexcept {
+    return mean * n / static_cast<double>(nnz);
+  }
+};
+
 struct ConfigAnalyzer {
   unsigned min_size{1U};
   unsigned max_size{1'000U};
@@ -83,6 +169,57 @@ std::map<Permutation, unsigned> getMapPerm2Index(
 std::vector<double> FLOPsOnInstances(std::vector<Algorithm>& A,
                                      const std::vector<Instance>& S);
 
+/**
+ * @brief Computes the cost of the parenthesisations in A on the instances in S
+ * under the passed cost model.
+ *
+ * Same layout as FLOPsOnInstances; FLOPsOnInstances(A, S) is
+ * CostOnInstances(A, S, FlopsModel{}). The resulting matrix can be fed to
+ * getMinA, getMinZ and getCostFromApprx to evaluate the approximation
+ * algorithms under the model.
+ *
+ * @param A     vector containing all the parenthesisations.
+ * @param S     vector containing the instances.
+ * @param model cost model (see cost_models.hpp).
+ * @return std::vector<double> matrix with the cost of all parenthesisations on
+ * every instance.
+ */
+template <typename CostModel>
+std::vector<double> CostOnInstances(std::vector<Algorithm>& A,
+                                    const std::vector<Instance>& S,
+                                    const CostModel& model) {
+  const unsigned M = A.size();
+  const unsigned N = S.size();
+  std::vector<double> cost_matrix(M * N);
+
+  for (unsigned j = 0U; j < N; j++) {
+    for (unsigned i = 0U; i < M; i++) {
+      cost_matrix[j * M + i] = A[i].computeCost(S[j], model);
+    }
+  }
+  return cost_matrix;
+}
+
+/**
+ * @brief Measures the execution time of the parenthesisations in A on the
+ * instances in S.
+ *
+ * Returns a matrix with the same layout as FLOPsOnInstances, where v(i,j) holds
+ * the time in seconds (minimum across n_reps runs) of executing the i-th
+ * parenthesisation on actual matrices sized by the j-th instance.
+ *
+ * @param A         vector containing all the parenthesisations.
+ * @param S         vector containing the instances.
+ * @param n_reps    number of repetitions per measurement.
+ * @param n_threads number of threads used by the multiplications (0 = all).
+ * @return std::vector<double> matrix with the execution time of all
+ * parenthesisations on every instance.
+ */
+std::vector<double> TimesOnInstances(const std::vector<Algorithm>& A,
+                                     const std::vector<Instance>& S,
+                                     const unsigned n_reps,
+                                     const unsigned n_threads = 0U);
+
 /**
  * @brief Returns a vector holding the minimum cost for each instance.
  *
@@ -95,6 +232,37 @@ std::vector<double> FLOPsOnInstances(std::vector<Algorithm>& A,
 std::vector<double> getMinA(const unsigned M, const unsigned N,
                             const std::vector<double>& cost_matrix);
 
+/**
+ * @brief Returns a vector holding the index of the cheapest parenthesisation
+ * for each instance.
+ *
+ * @param M                       number of parenthesisations in A.
+ * @param N                       number of instances in S.
+ * @param cost_matrix             MxN matrix in a vector.
+ * @return std::vector<unsigned>  vector of size N holding the index of the
+ * parenthesisation with minimum cost for each instance.
+ */
+std::vector<unsigned> getArgMinA(const unsigned M, const unsigned N,
+                                 const std::vector<double>& cost_matrix);
+
+/**
+ * @brief Returns the entries of the matrix selected by one parenthesisation's
+ * index per instance.
+ *
+ * Used to evaluate a choice made with one metric (e.g. FLOPs) under another
+ * (e.g. measured time).
+ *
+ * @param M                    number of parenthesisations in A.
+ * @param N                    number of instances in S.
+ * @param cost_matrix          MxN matrix in a vector.
+ * @param IDs                  index of the selected parenthesisation for
+ * every instance.
+ * @return std::vector<double> vector of size N.
+ */
+std::vector<double> getCostFromIDs(const unsigned M, const unsigned N,
+                                   const std::vector<double>& cost_matrix,
+                                   const std::vector<unsigned>& IDs);
+
 /**
  * @brief Returns a vector holding the minimum cost across the parenthesisations
  * in Z for all instances.
@@ -113,6 +281,60 @@ std::vector<double> getMinZ(const unsigned M, const unsigned N,
                             const std::vector<double>& cost_matrix,
                             const std::set<unsigned>& Z);
 
+/**
+ * @brief Computes the cost of all essential parenthesisations for every
+ * instance in S, without enumerating them nor building the cost matrix.
+ *
+ * Uses the O(n) closed form of essentialCosts, evaluated for all instances at
+ * once (instances are transposed so that the inner loops run across
+ * instances). All instances must have the same length n + 1. Returns a
+ * ((n+1) x N) matrix with the layout of FLOPsOnInstances: v(h,j) holds the
+ * cost of the essential parenthesisation fanning out from dimension h on the
+ * j-th instance.
+ *
+ * @param S                    vector containing the instances.
+ * @return std::vector<double> cost of every essential parenthesisation on
+ * every instance.
+ */
+std::vector<double> getEssentialCosts(const std::vector<Instance>& S);
+
+/**
+ * @brief Returns a vector holding the minimum cost across the essential
+ * parenthesisations for every instance in S.
+ *
+ * Equivalent to getMinZ over the IDs of the essential parenthesisations, but
+ * needs neither the set of all parenthesisations nor the cost matrix, so it
+ * works for chains of any length. All instances must have the same length.
+ *
+ * @param S                     vector containing the instances.
+ * @return std::vector<double>  minimum cost across the essentials.
+ */
+std::vector<double> getMinEssentials(const std::vector<Instance>& S);
+
+/**
+ * @brief Fused, single pass over the cost matrix.
+ *
+ * For every instance, computes the min and argmin over all of A, the min over
+ * every subset in Zs and the cost of the parenthesisation selected in every
+ * entry of IDs, while the instance's row of the cost matrix is in cache.
+ * Rows are swept in blocks, with the min reduction split into independent
+ * lanes so that it vectorizes. Replaces separate calls to getMinA,
+ * getArgMinA, getMinZ and getCostFromIDs (or getCostFromApprx, with the IDs
+ * from getIDsFromApprx).
+ *
+ * @param M             number of parenthesisations in A.
+ * @param N             number of instances in S.
+ * @param cost_matrix   MxN matrix in a vector.
+ * @param Zs            subsets of parenthesisations' IDs.
+ * @param IDs           selections: for each, one parenthesisation's ID per
+ * instance.
+ * @return CostReduction
+ */
+CostReduction reduceCostMatrix(const unsigned M, const unsigned N,
+                               const std::vector<double>& cost_matrix,
+                               const std::vector<std::set<unsigned>>& Zs,
+                               const std::vector<std::vector<unsigned>>& IDs);
+
 /**
  * @brief Computes the penalty of one instance given the overall cheapest cost
  * (min_A) and the cost of the parenthesisation of interest (min_Z).
@@ -145,6 +367,28 @@ std::vector<double> getPenaltyZ(const unsigned N,
 void printMetrics(const std::vector<double>& penalty_Z,
                   const std::string name_exp);
 
+/**
+ * @brief Prints the metrics accumulated in stats, with the confidence intervals
+ * for avg_penalty and freq_penalty.
+ *
+ * @param stats       accumulated penalties.
+ * @param name_exp    string - name of the experiment (approximation alg being
+ * used).
+ * @param z           quantile of the normal distribution for the intervals.
+ */
+void printMetrics(const PenaltyStats& stats, const std::string name_exp,
+                  const double z);
+
+/**
+ * @brief Prints metrics on a vector of relative savings (e.g. of memory or
+ * FLOPs), in the layout of printMetrics.
+ *
+ * @param saving      vector of savings for every instance.
+ * @param name_exp    string - name of the experiment.
+ */
+void printSavings(const std::vector<double>& saving,
+                  const std::string name_exp);
+
 /**
  * @brief Executes the passed approximation algorithm for the given instance.
  *
@@ -168,6 +412,20 @@ std::vector<Permutation> getPermFromApprx(
     const std::vector<Instance>& instances,
     std::function<Permutation(const Instance&)> apprx);
 
+/**
+ * @brief Returns the index in A of the parenthesisation yielded by the
+ * approximation algorithm for every instance in S.
+ *
+ * @param S           vector<instance>.
+ * @param perm2index  map from permutation to index.
+ * @param apprx       approximation algorithm to use.
+ * @return std::vector<unsigned>
+ */
+std::vector<unsigned> getIDsFromApprx(
+    const std::vector<Instance>& S,
+    const std::map<Permutation, unsigned>& perm2index,
+    std::function<Permutation(const Instance&)> apprx);
+
 /**
  * @brief Produces a vector with the costs of the parenthesisations yielded by
  * the passed approximation algorithm for all instances in S.
@@ -187,6 +445,36 @@ std::vector<double> getCostFromApprx(
     const std::map<Permutation, unsigned>& perm2index,
     std::function<Permutation(const Instance&)> apprx);
 
+/**
+ * @brief Produces a vector with the makespans, list-scheduled on n_workers
+ * (see listMakespan), of the parenthesisations yielded by the passed
+ * algorithm for all instances in S.
+ *
+ * Fed to getPenaltyZ together with the makespans of mc::planMakespan, it
+ * measures how much wall time a plan loses on parallel workers.
+ *
+ * @param S           vector<instance>.
+ * @param apprx       algorithm to use.
+ * @param n_workers   number of workers.
+ * @return std::vector<double>
+ */
+std::vector<double> getMakespanFromApprx(
+    const std::vector<Instance>& S,
+    std::function<Permutation(const Instance&)> apprx,
+    const unsigned n_workers);
+
+/**
+ * @brief Produces a vector with the critical paths (see criticalPath) of the
+ * parenthesisations yielded by the passed algorithm for all instances in S.
+ *
+ * @param S           vector<instance>.
+ * @param apprx       algorithm to use.
+ * @return std::vector<double>
+ */
+std::vector<double> getCriticalPathFromApprx(
+    const std::vector<Instance>& S,
+    std::function<Permutation(const Instance&)> apprx);
+
 }  // namespace mc
 
-#endif
\ No newline at end of file
+#endif
@@ -4,19 +4,48 @@
 #include <deque>
 #include <iostream>
 
+#include "algorithm.hpp"
 #include "definitions.hpp"
+#include "exact.hpp"
 #include "generator.hpp"
 #include "permutation.hpp"
+#include "reduction.hpp"
 
 namespace mc {
 
+namespace {
+
+// Applies reduceChain, assigning in v (Chin's format) the forced
+// multiplications: the first ones from a upwards, the last ones from b
+// downwards. Returns the dimensions of the remaining (reduced) chain.
+std::deque<int> applyReduction(const Instance& k, Permutation& v, int& a,
+                               int& b) {
+  const ChainReduction reduction = reduceChain(k);
+  for (const auto& p : reduction.first) v[p - 1] = a++;
+  for (auto it = reduction.last.rbegin(); it != reduction.last.rend(); it++)
+    v[*it - 1] = b--;
+  return std::deque<int>(reduction.index.begin(), reduction.index.end());
+}
+
+// Computes the operand spanning dimensions P.front() and P.back() as the fan
+// out from P[w]: the dimensions in between are eliminated from P[w] outwards,
+// and P[w] last. Assigns the multiplications in v (Chin's format) from a.
+void fanOut(const std::vector<int>& P, const int w, Permutation& v, int& a) {
+  for (int i = w - 1; i > 0; i--) v[P[i] - 1] = a++;
+  for (int i = w + 1; i + 1 < static_cast<int>(P.size()); i++)
+    v[P[i] - 1] = a++;
+  if (w > 0 and w + 1 < static_cast<int>(P.size())) v[P[w] - 1] = a++;
+}
+
+}  // namespace
+
 Permutation chandra(const Instance& k) {
   auto it_min = std::min_element(k.begin(), k.end());
   unsigned idx = static_cast<unsigned>(std::distance(k.begin(), it_min));
   return getEssentialPerm(k.size() - 1U, idx);
 }
 
-unsigned minEssential(const Instance& k) {
+std::vector<double> essentialCosts(const Instance& k) {
   const unsigned n = k.size() - 1U;
   std::vector<double> z(k.size());
   z[0] = static_cast<double>(k[0]) * static_cast<double>(k[n]);
@@ -32,6 +61,13 @@ unsigned minEssential(const Instance& k) {
     t[i] = static_cast<double>(k[i]) * (x - z[i] - z[i + 1]);
   t[n] = static_cast<double>(k[n]) * (x - z[n] - z[0]);
 
+  return t;
+}
+
+unsigned minEssential(const Instance& k) {
+  const unsigned n = k.size() - 1U;
+  std::vector<double> t = essentialCosts(k);
+
   unsigned h = 0U;
   double t_h = t[h];
   for (unsigned i = 1; i <= n; i++) {
@@ -50,43 +86,9 @@ Permutation chin(const Instance& k) {
   auto it_min = std::min_element(k.begin(), k.end());
   int m = static_cast<int>(std::distance(k.begin(), it_min));
 
-  std::vector<double> r(k.size());
-  for (int i = 0; i < static_cast<int>(k.size()); i++)
-    r[i] = 1.0 / static_cast<double>(k[i]);
-
   Permutation v(n - 1U);  // Chin's order of computation.
-
-  std::deque<int> Q;
-  // Scan forward.
-  Q.push_back(0U);
-  int a = 1U;
-
-  for (int i = 1U; i < n; i++) {
-    Q.push_back(i);
-    while (Q.size() >= 2U and
-           (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[i + 1U])) {
-      v[Q.back() - 1] = a;
-      a++;
-      Q.pop_back();
-    }
-  }
-  Q.push_back(n);
-  // Nibble at both ends.
-  int b = n - 1U;
-
-  while (Q.size() >= 3U) {
-    if (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[Q.front()]) {
-      Q.pop_back();
-      v[Q.back() - 1] = b;
-      b--;
-    } else if (r[Q.front()] + r[m] < r[Q[1]] + r[Q.back()]) {
-      Q.pop_front();
-      v[Q.front() - 1] = b;
-      b--;
-    } else {
-      break;
-    }
-  }
+  int a = 1U, b = n - 1U;
+  std::deque<int> Q = applyReduction(k, v, a, b);
 
   // Associate out from smallest dimension.
   for (int i = m - 1; i > Q.front(); i--) {
@@ -115,48 +117,9 @@ Permutation chin(const Instance& k) {
 Permutation reduceMin(const Instance& k) {
   const int n = k.size() - 1U;
 
-  // Initialise.
-  auto it_min = std::min_element(k.begin(), k.end());
-  int m = static_cast<int>(std::distance(k.begin(), it_min));
-
-  std::vector<double> r(k.size());
-  for (int i = 0U; i < static_cast<int>(k.size()); i++)
-    r[i] = 1.0 / static_cast<double>(k[i]);
-
   Permutation v(n - 1U);  // Chin's order of computation.
-
-  std::deque<int> Q;
-  // Scan forward.
-  Q.push_back(0U);
-  int a = 1U;
-
-  for (int i = 1U; i < n; i++) {
-    Q.push_back(i);
-    while (Q.size() >= 2U and
-           (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[i + 1U])) {
-      v[Q.back() - 1] = a;
-      a++;
-      Q.pop_back();
-    }
-  }
-  Q.push_back(n);
-
-  // Nibble at both ends.
-  int b = n - 1U;
-
-  while (Q.size() >= 3U) {
-    if (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[Q.front()]) {
-      Q.pop_back();
-      v[Q.back() - 1] = b;
-      b--;
-    } else if (r[Q.front()] + r[m] < r[Q[1]] + r[Q.back()]) {
-      Q.pop_front();
-      v[Q.front() - 1] = b;
-      b--;
-    } else {
-      break;
-    }
-  }
+  int a = 1U, b = n - 1U;
+  std::deque<int> Q = applyReduction(k, v, a, b);
 
   // minimise over the essential parenth of the remaining chain.
   if (Q.size() >= 3) {
@@ -190,6 +153,199 @@ Permutation reduceMin(const Instance& k) {
   return chin2Canonical(v);
 }
 
+Permutation huShing(const Instance& k) {
+  const int n = k.size() - 1U;
+
+  Permutation v(n - 1U);  // Chin's order of computation.
+  int a = 1U, b = n - 1U;
+  std::deque<int> Q = applyReduction(k, v, a, b);
+  const int L = Q.size();
+
+  // Candidate 1: fan out from V1, the smallest vertex of the reduced polygon.
+  std::vector<int> P(Q.begin(), Q.end());
+  int v1 = 0;
+  for (int i = 1; i < L; i++)
+    if (k[Q[i]] < k[Q[v1]]) v1 = i;
+  Permutation fan = v;
+  int a_fan = a;
+  fanOut(P, v1, fan, a_fan);
+  Permutation best = chin2Canonical(fan);
+  if (L < 4) return best;
+
+  // Candidate 2: cut along the arc V2-V3 (the second and third smallest
+  // vertices), fan out from V1 on its side of the cut and from V2 on the
+  // other.
+  int v2 = -1, v3 = -1;
+  for (int i = 0; i < L; i++) {
+    if (i == v1) continue;
+    if (v2 == -1 or k[Q[i]] < k[Q[v2]]) {
+      v3 = v2;
+      v2 = i;
+    } else if (v3 == -1 or k[Q[i]] < k[Q[v3]]) {
+      v3 = i;
+    }
+  }
+  const int lo = std::min(v2, v3), hi = std::max(v2, v3);
+  if (hi - lo == 1 or (lo == 0 and hi == L - 1)) return best;  // A side.
+
+  // Inner polygon Q[lo..hi], computed first, and outer polygon with the arc
+  // as one of its sides.
+  std::vector<int> inner(Q.begin() + lo, Q.begin() + hi + 1);
+  std::vector<int> outer(Q.begin(), Q.begin() + lo + 1);
+  outer.insert(outer.end(), Q.begin() + hi, Q.end());
+  const bool v1_inner = (lo < v1 and v1 < hi);
+  const int v2_pos = (v2 == lo) ? 0 : hi - lo;  // Position of V2 in inner.
+  const int w_inner = v1_inner ? v1 - lo : v2_pos;
+  const int w_outer =
+      v1_inner ? ((v2 == lo) ? lo : lo + 1) : (v1 < lo ? v1 : v1 - hi + lo + 1);
+
+  Permutation cut = v;
+  int a_cut = a;
+  fanOut(inner, w_inner, cut, a_cut);
+  fanOut(outer, w_outer, cut, a_cut);
+  Permutation candidate = chin2Canonical(cut);
+
+  if (permutationFlops(candidate, k) < permutationFlops(best, k))
+    best = std::move(candidate);
+  return best;
+}
+
+Permutation polish(const Permutation& perm, const Instance& k,
+                   const unsigned budget) {
+  const unsigned n = k.size() - 1U;
+  if (perm.size() < 2U) return perm;
+
+  // Node p is the multiplication at dimension p, whose result spans
+  // [lo[p], hi[p]]. Child 0 stands for an input matrix.
+  std::vector<unsigned> left(n), right(n), parent(n), lo(n), hi(n);
+  {
+    // prev/next link the dimensions that are still alive; op[d] is the
+    // multiplication that produced the operand starting at d.
+    std::vector<unsigned> prev(n + 1U), next(n + 1U), op(n + 1U, 0U);
+    for (unsigned i = 0U; i <= n; i++) {
+      prev[i] = i - 1U;
+      next[i] = i + 1U;
+    }
+    for (const auto& p : perm) {
+      lo[p] = prev[p];
+      hi[p] = next[p];
+      left[p] = op[lo[p]];
+      right[p] = op[p];
+      parent[left[p]] = parent[right[p]] = p;
+      op[lo[p]] = p;
+      next[lo[p]] = hi[p];
+      prev[hi[p]] = lo[p];
+    }
+  }
+  unsigned root = perm.back();
+
+  auto c = [&k](const unsigned a, const unsigned b, const unsigned d) {
+    return static_cast<double>(k[a]) * static_cast<double>(k[b]) *
+           static_cast<double>(k[d]);
+  };
+
+  // Window rooted at x: the operands hanging polish_window_depth levels below
+  // x (or higher, where the tree ends) in left-to-right order, and the
+  // dimensions between them, which are the multiplications inside the window.
+  constexpr unsigned max_operands = 1U << polish_window_depth;
+  constexpr unsigned max_dims = max_operands + 1U;
+  unsigned operand[max_operands];  // Node of every operand (0 = input).
+  unsigned bound[max_dims];        // Dimensions around the operands.
+  unsigned dims[max_dims];         // Their sizes.
+  double cost[max_dims * max_dims];
+  unsigned split[max_dims * max_dims];
+  unsigned order[max_operands], order_stack[2U * max_dims];
+  unsigned prev[max_dims], next[max_dims], op[max_dims];
+
+  struct Visit {
+    unsigned node, depth;
+    bool emit;  // Visit the multiplication itself, between its children.
+  };
+  Visit dfs[3U * polish_window_depth + 1U];
+
+  for (unsigned sweep = 0U; sweep < budget; sweep++) {
+    bool improved = false;
+    for (unsigned x = 1U; x < n; x++) {
+      if (left[x] == 0U and right[x] == 0U) continue;  // Nothing to rotate.
+
+      // In-order traversal of the window.
+      unsigned m = 0U, top = 0U;
+      double current = 0.0;
+      bound[0] = lo[x];
+      dfs[top++] = {x, 0U, false};
+      while (top > 0U) {
+        const Visit v = dfs[--top];
+        if (v.emit) {
+          bound[m] = v.node;
+        } else if (v.node == 0U or v.depth == polish_window_depth) {
+          operand[m++] = v.node;
+        } else {
+          current += c(lo[v.node], v.node, hi[v.node]);
+          dfs[top++] = {right[v.node], v.depth + 1U, false};
+          dfs[top++] = {v.node, v.depth, true};
+          dfs[top++] = {left[v.node], v.depth + 1U, false};
+        }
+      }
+      bound[m] = hi[x];
+      for (unsigned i = 0U; i <= m; i++) dims[i] = k[bound[i]];
+
+      const double best = exactSplits(dims, m, cost, split);
+      if (!(best < current * (1.0 - 1e-12))) continue;
+      splitsToOrder(m, split, order_stack, order);
+
+      // Rebuild the window from the new order, as in the construction.
+      const unsigned up = parent[x];
+      const bool is_root = (x == root), is_left = !is_root and left[up] == x;
+      for (unsigned i = 0U; i <= m; i++) {
+        prev[i] = i - 1U;
+        next[i] = i + 1U;
+        op[i] = (i < m) ? operand[i] : 0U;
+      }
+      unsigned y = x;
+      for (unsigned s = 0U; s + 1U < m; s++) {
+        const unsigned p = order[s], l = prev[p], h = next[p];
+        y = bound[p];
+        lo[y] = bound[l];
+        hi[y] = bound[h];
+        left[y] = op[l];
+        right[y] = op[p];
+        parent[left[y]] = parent[right[y]] = y;
+        op[l] = y;
+        next[l] = h;
+        prev[h] = l;
+      }
+      parent[y] = up;
+      if (is_root)
+        root = y;
+      else if (is_left)
+        left[up] = y;
+      else
+        right[up] = y;
+      improved = true;
+    }
+    if (!improved) break;
+  }
+
+  // Post-order (left, right, root) is the canonical form: emit root, right,
+  // left and reverse.
+  Permutation polished;
+  polished.reserve(perm.size());
+  std::vector<unsigned> stack{root};
+  while (!stack.empty()) {
+    const unsigned p = stack.back();
+    stack.pop_back();
+    polished.push_back(p);
+    if (left[p] != 0U) stack.push_back(left[p]);
+    if (right[p] != 0U) stack.push_back(right[p]);
+  }
+  std::reverse(polished.begin(), polished.end());
+  return polished;
+}
+
+Permutation reduceMinPolished(const Instance& k) {
+  return polish(reduceMin(k), k);
+}
+
 Permutation chin2Canonical(const Permutation& chins_perm) {
   Permutation canonical_perm(chins_perm.size());
   for (unsigned i = 0; i < chins_perm.size(); i++) {
@@ -7,6 +7,9 @@
 
 namespace mc {
 
+constexpr unsigned default_polish_budget = 4U;  // Sweeps of polish.
+constexpr unsigned polish_window_depth = 3U;    // Levels re-bracketed at once.
+
 /**
  * @brief Executes Chandra's approximation algorithm on the passed instance.
  *
@@ -19,6 +22,18 @@ namespace mc {
  */
 Permutation chandra(const Instance& k);
 
+/**
+ * @brief Computes the cost of all n+1 essential parenthesisations of the given
+ * instance in O(n).
+ *
+ * The h-th entry holds the cost of the essential parenthesisation that fans
+ * out from dimension h (i.e. getEssentialPerm(n, h)).
+ *
+ * @param k                     Instance.
+ * @return std::vector<double>  Cost of every essential parenthesisation.
+ */
+std::vector<double> essentialCosts(const Instance& k);
+
 /**
  * @brief Finds the index of the dimension of the essential parenthesisation
  * with minimal cost for the given instance.
@@ -52,6 +67,55 @@ Permutation chin(const Instance& k);
  */
 Permutation reduceMin(const Instance& k);
 
+/**
+ * @brief Executes a simplified heuristic in the style of Hu and Shing's on
+ * the passed instance.
+ *
+ * After the reduction by Lemma 1 in (Chin 1978), compares on the remaining
+ * polygon the fan out from the smallest vertex V1 with the partition that
+ * cuts along the arc between the second and third smallest vertices V2-V3
+ * and fans out from V1 and V2 on either side, and returns the cheaper. Runs
+ * in O(n).
+ *
+ * This is not the full algorithm of Hu and Shing, which considers every
+ * potential arc and is proven within 15.47% of the optimum: only these two
+ * candidates are compared, and no bound is proven for them.
+ *
+ * Reference: T.C. Hu and M.T. Shing. An O(n) algorithm to find a near-optimum
+ * partition of a convex polygon. Journal of Algorithms. 1981.
+ *
+ * @param k             Instance.
+ * @return Permutation  Yielded order of computation (in our convention).
+ */
+Permutation huShing(const Instance& k);
+
+/**
+ * @brief Refines an order of computation by local search over tree rotations.
+ *
+ * Every sweep visits all multiplications and replaces the subtree formed by
+ * the polish_window_depth levels below each with its cheapest re-bracketing,
+ * i.e. the best sequence of rotations within the window (depth 2 would be a
+ * single rotation). A window has at most 2^polish_window_depth operands, so
+ * its change in cost is evaluated in O(1) and a sweep takes O(n). Stops after
+ * a sweep without improvement or after budget sweeps.
+ *
+ * @param perm          order of computation to refine.
+ * @param k             Instance.
+ * @param budget        maximum number of sweeps.
+ * @return Permutation  Refined order of computation (in canonical form), never
+ * more expensive than perm.
+ */
+Permutation polish(const Permutation& perm, const Instance& k,
+                   const unsigned budget = default_polish_budget);
+
+/**
+ * @brief Executes Algorithm 3 followed by polish.
+ *
+ * @param k             Instance.
+ * @return Permutation  Yielded order of computation (in our convention).
+ */
+Permutation reduceMinPolished(const Instance& k);
+
 /**
  * @brief Converts Chin's notation of the order of computation to our notation.
  *
@@ -0,0 +1,36 @@
+#include "apprx_registry.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "analyzer.hpp"
+#include "apprx_algorithms.hpp"
+#include "generator.hpp"
+
+namespace mc {
+
+const std::vector<Approximation>& getApproximations() {
+  static const std::vector<Approximation> registry = {
+      {"essentials", "Essentials", nullptr, getEssentialPerms,
+       apprx_canonical | apprx_fixed_set, getMinEssentials},
+      {"chandra", "Chandra's", chandra, nullptr,
+       apprx_canonical | apprx_any_length},
+      {"chin", "Chin's", chin, nullptr, apprx_canonical | apprx_any_length},
+      {"huShing", "Hu-Shing's", huShing, nullptr,
+       apprx_canonical | apprx_any_length},
+      {"reduceMin", "Algorithm 3", reduceMin, nullptr,
+       apprx_canonical | apprx_any_length},
+      {"reduceMinPolished", "Algorithm 3 (polished)", reduceMinPolished,
+       nullptr, apprx_canonical | apprx_any_length},
+  };
+  return registry;
+}
+
+const Approximation& findApproximation(const std::string& name) {
+  for (const auto& apprx : getApproximations())
+    if (apprx.name == name) return apprx;
+  throw std::invalid_argument("Unknown approximation: " + name);
+}
+
+}  // namespace mc
@@ -0,0 +1,58 @@
+#ifndef APPRX_REGISTRY_H
+#define APPRX_REGISTRY_H
+
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Capability flags of a registered approximation. ExperimentEngine looks the
+// orders of apprx_canonical ones up without canonicalising them and evaluates
+// apprx_fixed_set ones through candidates; the long-chain drivers (scaling)
+// only run apprx_any_length ones.
+constexpr unsigned apprx_canonical = 1U << 0;   // Yields canonical orders.
+constexpr unsigned apprx_any_length = 1U << 1;  // Near-linear: any n.
+constexpr unsigned apprx_fixed_set = 1U << 2;   // Best of a fixed set.
+
+struct Approximation {
+  std::string name;   // Identifier, also the prefix of exported columns.
+  std::string label;  // Name shown in reports.
+  // Either solve yields the order of computation for an instance, or
+  // candidates lists, for a chain length, a fixed set of orders of which the
+  // cheapest under the cost model in use is taken (apprx_fixed_set).
+  Permutation (*solve)(const Instance&){nullptr};
+  std::vector<Permutation> (*candidates)(const unsigned){nullptr};
+  unsigned capabilities{0U};
+  // Optionally, the costs under FLOPs of a batch of instances of the same
+  // length in closed form, used by ExperimentEngine under FlopsModel.
+  std::vector<double> (*flops_costs)(const std::vector<Instance>&){nullptr};
+
+  inline bool has(const unsigned capability) const noexcept {
+    return (capabilities & capability) == capability;
+  }
+};
+
+/**
+ * @brief Returns all registered approximations, in reporting order.
+ *
+ * Registering a new approximation is one entry in apprx_registry.cpp; the
+ * experiment drivers iterate over this list.
+ *
+ * @return const std::vector<Approximation>&
+ */
+const std::vector<Approximation>& getApproximations();
+
+/**
+ * @brief Returns the registered approximation with the passed name. Throws
+ * std::invalid_argument if there is none.
+ *
+ * @param name                  identifier, e.g. "reduceMin".
+ * @return const Approximation&
+ */
+const Approximation& findApproximation(const std::string& name);
+
+}  // namespace mc
+
+#endif
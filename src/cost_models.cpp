@@ -0,0 +1,94 @@
+#include "cost_models.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "executor.hpp"
+
+namespace mc {
+
+namespace {
+
+// Returns the lower grid index and the weight of the upper one for x.
+void bracket(const std::vector<unsigned>& grid, const unsigned x,
+             unsigned& lower, double& weight) {
+  if (grid.size() == 1U or x <= grid.front()) {
+    lower = 0U;
+    weight = 0.0;
+    return;
+  }
+  if (x >= grid.back()) {
+    lower = grid.size() - 2U;
+    weight = 1.0;
+    return;
+  }
+
+  auto it = std::upper_bound(grid.begin(), grid.end(), x);
+  lower = static_cast<unsigned>(std::distance(grid.begin(), it)) - 1U;
+  weight = std::log(static_cast<double>(x) / grid[lower]) /
+           std::log(static_cast<double>(grid[lower + 1U]) / grid[lower]);
+}
+
+}  // namespace
+
+TableModel::TableModel(const std::vector<unsigned>& grid,
+                       const std::vector<double>& seconds_per_flop)
+    : grid{grid}, seconds_per_flop{seconds_per_flop} {}
+
+TableModel TableModel::calibrate(const std::vector<unsigned>& grid,
+                                 const unsigned n_reps,
+                                 const unsigned n_threads) {
+  const unsigned G = grid.size();
+  const unsigned max_size = grid.back();
+  std::vector<double> A(static_cast<size_t>(max_size) * max_size, 1.0);
+  std::vector<double> B(A.size(), 1.0);
+  std::vector<double> C(A.size(), 0.0);
+
+  std::vector<double> seconds_per_flop(G * G * G);
+  for (unsigned im = 0U; im < G; im++) {
+    for (unsigned ik = 0U; ik < G; ik++) {
+      for (unsigned in = 0U; in < G; in++) {
+        const unsigned m = grid[im], k = grid[ik], n = grid[in];
+        double best = std::numeric_limits<double>::max();
+        for (unsigned r = 0U; r < n_reps; r++) {
+          auto start = std::chrono::steady_clock::now();
+          gemm(m, k, n, A.data(), B.data(), C.data(), n_threads);
+          auto end = std::chrono::steady_clock::now();
+          best = std::min(best,
+                          std::chrono::duration<double>(end - start).count());
+        }
+        seconds_per_flop[(im * G + ik) * G + in] = best / FlopsModel{}(m, k, n);
+      }
+    }
+  }
+  return TableModel(grid, seconds_per_flop);
+}
+
+double TableModel::operator()(const unsigned m, const unsigned k,
+                              const unsigned n) const {
+  const unsigned G = grid.size();
+  unsigned lm, lk, ln;
+  double wm, wk, wn;
+  bracket(grid, m, lm, wm);
+  bracket(grid, k, lk, wk);
+  bracket(grid, n, ln, wn);
+
+  double efficiency = 0.0;
+  for (unsigned dm = 0U; dm <= 1U; dm++) {
+    for (unsigned dk = 0U; dk <= 1U; dk++) {
+      for (unsigned dn = 0U; dn <= 1U; dn++) {
+        const double w = (dm ? wm : 1.0 - wm) * (dk ? wk : 1.0 - wk) *
+                         (dn ? wn : 1.0 - wn);
+        if (w == 0.0) continue;
+        efficiency +=
+            w * seconds_per_flop[((lm + dm) * G + lk + dk) * G + ln + dn];
+      }
+    }
+  }
+  return efficiency * FlopsModel{}(m, k, n);
+}
+
+}  // namespace mc
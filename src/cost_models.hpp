@@ -0,0 +1,107 @@
+#ifndef COST_MODELS_H
+#define COST_MODELS_H
+
+#include <algorithm>
+#include <vector>
+
+namespace mc {
+
+// A cost model is any type exposing
+//    double operator()(const unsigned m, const unsigned k,
+//                      const unsigned n) const;
+// which returns the cost of multiplying a (m x k) matrix by a (k x n) matrix.
+// The cost of a parenthesisation is the sum of the costs of its
+// multiplications.
+
+struct FlopsModel {  // costMult(m,k,n) = m * k * n.
+  double operator()(const unsigned m, const unsigned k,
+                    const unsigned n) const {
+    return static_cast<double>(m) * static_cast<double>(k) *
+           static_cast<double>(n);
+  }
+};
+
+struct BytesModel {  // Bytes moved: read A, read B, write C.
+  unsigned element_bytes{8U};
+
+  BytesModel() = default;
+
+  BytesModel(const unsigned element_bytes) : element_bytes{element_bytes} {}
+
+  double operator()(const unsigned m, const unsigned k,
+                    const unsigned n) const {
+    const double dm = m, dk = k, dn = n;
+    return element_bytes * (dm * dk + dk * dn + dm * dn);
+  }
+};
+
+struct RooflineModel {  // Time in seconds = max(compute, memory).
+  double peak_flops{1e11};     // FLOP/s.
+  double peak_bandwidth{2e10};  // bytes/s.
+  unsigned element_bytes{8U};
+
+  RooflineModel() = default;
+
+  RooflineModel(const double peak_flops, const double peak_bandwidth,
+                const unsigned element_bytes = 8U)
+      : peak_flops{peak_flops},
+        peak_bandwidth{peak_bandwidth},
+        element_bytes{element_bytes} {}
+
+  double operator()(const unsigned m, const unsigned k,
+                    const unsigned n) const {
+    const double compute = 2.0 * FlopsModel{}(m, k, n) / peak_flops;
+    const double memory = BytesModel{element_bytes}(m, k, n) / peak_bandwidth;
+    return std::max(compute, memory);
+  }
+};
+
+class TableModel {  // Time in seconds interpolated from measured GEMMs.
+ private:
+  std::vector<unsigned> grid;  // Sizes sampled along m, k and n (sorted).
+  std::vector<double> seconds_per_flop;  // grid^3 entries, indexed [m][k][n].
+
+ public:
+  TableModel() = delete;
+
+  /**
+   * @brief Parametrised constructor from already measured data.
+   *
+   * @param grid              sizes sampled along every dimension, ascending.
+   * @param seconds_per_flop  measured time divided by m * k * n for every
+   * (m,k,n) in grid^3, indexed as [(im * grid.size() + ik) * grid.size() + in].
+   */
+  TableModel(const std::vector<unsigned>& grid,
+             const std::vector<double>& seconds_per_flop);
+
+  /**
+   * @brief Fits a table model by timing the GEMM kernel on every (m,k,n) in
+   * grid^3.
+   *
+   * @param grid        sizes to sample along every dimension, ascending.
+   * @param n_reps      repetitions per measurement (the minimum is kept).
+   * @param n_threads   number of threads used by the kernel (0 = all).
+   * @return TableModel
+   */
+  static TableModel calibrate(const std::vector<unsigned>& grid,
+                              const unsigned n_reps,
+                              const unsigned n_threads = 0U);
+
+  /**
+   * @brief Returns the estimated time of the multiplication, interpolating the
+   * measured efficiency linearly in log-space between the grid points and
+   * clamping outside of it.
+   */
+  double operator()(const unsigned m, const unsigned k,
+                    const unsigned n) const;
+
+  // Getters for the fitted data.
+  inline const std::vector<unsigned>& getGrid() const noexcept { return grid; }
+  inline const std::vector<double>& getSecondsPerFlop() const noexcept {
+    return seconds_per_flop;
+  }
+};
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,171 @@
+#include "dyck.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.hpp"
+#include "generator.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+// Scans the word once, calling visit(i, s, j) for every multiplication, in
+// post-order, where the product spans dimensions i..j and is split at s.
+// Throws std::invalid_argument unless the word is the Dyck word of a chain of
+// length n >= 2: its 2(n-1) symbols are balanced and no higher bit is set.
+template <typename Word, typename Visitor>
+void scanDyck(const Word word, const unsigned n, Visitor&& visit) {
+  struct Open {  // A multiplication whose right operand is not done yet.
+    unsigned first, split;
+    bool right;  // Whether its left operand is done (split is known).
+  };
+  std::array<Open, dyckMaxLength<Word>()> stack;
+  unsigned top = 0U, leaves = 0U, n_open = 0U;
+  const unsigned length = 2U * (n - 1U);
+  if (length < 8U * sizeof(Word) and (word >> length) != Word{0})
+    throw std::invalid_argument("Invalid Dyck word");
+  bool after_open = false;
+  for (unsigned t = 0U; t < length; t++) {
+    if ((word >> t) & 1U) {
+      if (++n_open > n - 1U) throw std::invalid_argument("Invalid Dyck word");
+      stack[top++] = {leaves, 0U, false};
+      after_open = true;
+      continue;
+    }
+    if (after_open) leaves++;  // The left operand is an input.
+    while (top > 0U and stack[top - 1U].right) {
+      visit(stack[top - 1U].first, stack[top - 1U].split, leaves);
+      top--;
+    }
+    if (top == 0U) throw std::invalid_argument("Invalid Dyck word");
+    stack[top - 1U].right = true;
+    stack[top - 1U].split = leaves;
+    if (t + 1U == length or !((word >> (t + 1U)) & 1U))
+      leaves++;  // The right operand is an input.
+    after_open = false;
+  }
+  if (n_open != n - 1U) throw std::invalid_argument("Invalid Dyck word");
+  while (top > 0U) {
+    visit(stack[top - 1U].first, stack[top - 1U].split, leaves);
+    top--;
+  }
+}
+
+template <typename Word>
+void checkLength(const unsigned n) {
+  if (n > dyckMaxLength<Word>())
+    throw std::length_error("Chain too long for the Dyck word");
+}
+
+// A chain of one matrix has only the empty word; none has no word.
+template <typename Word>
+void checkSingle(const Word word, const unsigned n) {
+  if (n == 0U or (n == 1U and word != Word{0}))
+    throw std::invalid_argument("Invalid Dyck word");
+}
+
+template <typename Word>
+void appendWords(const unsigned pos, const unsigned length,
+                 const unsigned n_open, const unsigned n_close,
+                 const Word prefix, std::vector<Word>& words) {
+  if (pos == length) {
+    words.push_back(prefix);
+    return;
+  }
+  if (n_close < n_open)
+    appendWords(pos + 1U, length, n_open, n_close + 1U, prefix, words);
+  if (2U * n_open < length)
+    appendWords(pos + 1U, length, n_open + 1U, n_close,
+                prefix | (Word{1} << pos), words);
+}
+
+}  // namespace
+
+template <typename Word>
+Word toDyck(const Permutation& perm) {
+  const unsigned n = perm.size() + 1U;
+  checkLength<Word>(n);
+
+  // Children of every multiplication (-1 for an input).
+  std::vector<int> left(perm.size()), right(perm.size()), op(n + 1U, -1);
+  visitOrder(perm, n,
+             [&](const unsigned s, const unsigned lo, const unsigned p,
+                 unsigned) {
+               left[s] = op[lo];
+               right[s] = op[p];
+               op[lo] = s;
+             });
+
+  // Pre-order: 1, left operand, 0, right operand.
+  constexpr int close = -1;
+  Word word = 0U;
+  unsigned t = 0U;
+  std::vector<int> stack;
+  if (!perm.empty()) stack.push_back(perm.size() - 1U);
+  while (!stack.empty()) {
+    const int x = stack.back();
+    stack.pop_back();
+    if (x == close) {
+      t++;
+      continue;
+    }
+    word |= Word{1} << t++;
+    if (right[x] >= 0) stack.push_back(right[x]);
+    stack.push_back(close);
+    if (left[x] >= 0) stack.push_back(left[x]);
+  }
+  return word;
+}
+
+template <typename Word>
+Permutation fromDyck(const Word word, const unsigned n) {
+  checkLength<Word>(n);
+  checkSingle(word, n);
+  Permutation perm;
+  if (n < 2U) return perm;
+  perm.reserve(n - 1U);
+  scanDyck(word, n, [&perm](const unsigned, const unsigned s, const unsigned) {
+    perm.push_back(s);
+  });
+  return perm;
+}
+
+template <typename Word>
+double dyckFlops(const Word word, const Instance& k) {
+  if (k.size() < 2U)
+    throw std::invalid_argument("Instance with fewer than two dimensions");
+  const unsigned n = k.size() - 1U;
+  checkLength<Word>(n);
+  checkSingle(word, n);
+  double flops = 0.0;
+  if (n < 2U) return flops;
+  scanDyck(word, n,
+           [&flops, &k](const unsigned i, const unsigned s, const unsigned j) {
+             flops += static_cast<double>(k[i]) * k[s] * k[j];
+           });
+  return flops;
+}
+
+template <typename Word>
+std::vector<Word> generateDyckWords(const unsigned n) {
+  checkLength<Word>(n);
+  std::vector<Word> words;
+  if (n < 2U) return std::vector<Word>(1U, Word{0});  // A single matrix.
+  if (n - 1U <= 36U) words.reserve(catalanNumber(n - 1U));
+  appendWords<Word>(0U, 2U * (n - 1U), 0U, 0U, Word{0}, words);
+  return words;
+}
+
+template DyckWord toDyck(const Permutation&);
+template DyckWord128 toDyck(const Permutation&);
+template Permutation fromDyck(const DyckWord, const unsigned);
+template Permutation fromDyck(const DyckWord128, const unsigned);
+template double dyckFlops(const DyckWord, const Instance&);
+template double dyckFlops(const DyckWord128, const Instance&);
+template std::vector<DyckWord> generateDyckWords(const unsigned);
+template std::vector<DyckWord128> generateDyckWords(const unsigned);
+
+}  // namespace mc
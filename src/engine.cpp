@@ -0,0 +1,118 @@
+#include "engine.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "analyzer.hpp"
+#include "definitions.hpp"
+#include "generator.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+constexpr unsigned engine_block_doubles = 1U << 16;  // 512 KiB of costs.
+
+}  // namespace
+
+ExperimentEngine::ExperimentEngine(
+    const unsigned n, const std::vector<Approximation>& approximations)
+    : A{generateAlgorithms(n)},
+      approximations{approximations},
+      candidate_IDs(approximations.size()),
+      stats(approximations.size()) {
+  perm2index = getMapPerm2Index(A);
+  for (unsigned a = 0U; a < approximations.size(); a++) {
+    const Approximation& apprx = approximations[a];
+    if (apprx.has(apprx_fixed_set) ? apprx.candidates == nullptr
+                                   : apprx.solve == nullptr)
+      throw std::invalid_argument("ExperimentEngine: " + apprx.name +
+                                  " lacks the function its flags require");
+    if (!apprx.has(apprx_fixed_set)) continue;
+    for (const auto& perm : apprx.candidates(n))
+      candidate_IDs[a].insert(indexOf(perm));
+  }
+}
+
+unsigned ExperimentEngine::indexOf(const Permutation& perm) const {
+  auto it = perm2index.find(perm);
+  if (it != perm2index.end()) return it->second;
+  return perm2index.at(PermutationTransformer::canonicalize(perm));
+}
+
+EngineBatch ExperimentEngine::run(const std::vector<Instance>& S) {
+  const unsigned N = S.size(), R = approximations.size(), M = A.size();
+  EngineBatch batch;
+  batch.min_A.resize(N);
+  batch.argmin_A.resize(N);
+  batch.costs.assign(R, std::vector<double>(N));
+  batch.penalties.assign(R, std::vector<double>(N));
+
+  // Closed forms cost whole batches; the other approximations are reduced
+  // as subsets (Zs) or selections (IDs) of the rows.
+  std::vector<bool> closed(R);
+  std::vector<std::set<unsigned>> Zs;
+  std::vector<unsigned> z_of(R), id_of(R);
+  unsigned n_IDs = 0U;
+  for (unsigned a = 0U; a < R; a++) {
+    const Approximation& apprx = approximations[a];
+    closed[a] = flops_model and apprx.flops_costs != nullptr;
+    if (closed[a]) {
+      batch.costs[a] = apprx.flops_costs(S);
+    } else if (apprx.has(apprx_fixed_set)) {
+      z_of[a] = Zs.size();
+      Zs.push_back(candidate_IDs[a]);
+    } else {
+      id_of[a] = n_IDs++;
+    }
+  }
+
+  const unsigned block_size = std::max(1U, engine_block_doubles / M);
+  std::vector<std::vector<unsigned>> IDs(n_IDs);
+  for (unsigned j0 = 0U; j0 < N; j0 += block_size) {
+    const unsigned B = std::min(block_size, N - j0);
+    const std::vector<Instance> S_block(S.begin() + j0, S.begin() + j0 + B);
+    block.resize(static_cast<std::size_t>(B) * M);
+    for (unsigned j = 0U; j < B; j++)
+      row_cost(A, S_block[j], block.data() + static_cast<std::size_t>(j) * M);
+
+    for (unsigned a = 0U; a < R; a++) {
+      const Approximation& apprx = approximations[a];
+      if (closed[a] or apprx.has(apprx_fixed_set)) continue;
+      if (apprx.has(apprx_canonical)) {
+        IDs[id_of[a]] = getIDsFromApprx(S_block, perm2index, apprx.solve);
+      } else {
+        IDs[id_of[a]].resize(B);
+        for (unsigned j = 0U; j < B; j++)
+          IDs[id_of[a]][j] = indexOf(apprx.solve(S_block[j]));
+      }
+    }
+    const CostReduction reduction = reduceCostMatrix(M, B, block, Zs, IDs);
+
+    for (unsigned j = 0U; j < B; j++) {
+      batch.min_A[j0 + j] = reduction.min_A[j];
+      batch.argmin_A[j0 + j] = reduction.argmin_A[j];
+      for (unsigned a = 0U; a < R; a++) {
+        if (closed[a]) continue;
+        batch.costs[a][j0 + j] =
+            approximations[a].has(apprx_fixed_set)
+                ? reduction.min_Z[z_of[a]][j]
+                : reduction.cost_IDs[id_of[a]][j];
+      }
+    }
+  }
+
+  for (unsigned a = 0U; a < R; a++) {
+    for (unsigned j = 0U; j < N; j++) {
+      batch.penalties[a][j] = penalty(batch.min_A[j], batch.costs[a][j]);
+      stats[a].add(batch.penalties[a][j]);
+    }
+  }
+  return batch;
+}
+
+}  // namespace mc
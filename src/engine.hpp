@@ -0,0 +1,109 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <functional>
+#include <map>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "analyzer.hpp"
+#include "apprx_registry.hpp"
+#include "cost_models.hpp"
+#include "definitions.hpp"
+
+namespace mc {
+
+struct EngineBatch {  // Per-instance results of one call to run.
+  std::vector<double> min_A;                  // Minimum per instance.
+  std::vector<unsigned> argmin_A;             // Its index in A per instance.
+  std::vector<std::vector<double>> costs;     // Per approximation.
+  std::vector<std::vector<double>> penalties;  // Per approximation.
+};
+
+class ExperimentEngine {  // Evaluates registered approximations in one pass.
+ private:
+  using RowCost =
+      std::function<void(std::vector<Algorithm>&, const Instance&, double*)>;
+
+  std::vector<Algorithm> A;
+  std::map<Permutation, unsigned> perm2index;
+  std::vector<Approximation> approximations;
+  std::vector<std::set<unsigned>> candidate_IDs;  // Per apprx_fixed_set.
+  RowCost row_cost;
+  bool flops_model{false};     // Whether closed-form FLOP costs apply.
+  std::vector<double> block;   // Cost rows of a block of instances.
+  std::vector<PenaltyStats> stats;
+
+ public:
+  ExperimentEngine() = delete;
+
+  /**
+   * @brief Parametrised constructor. Enumerates all parenthesisations of a
+   * chain of length n, against which the approximations are compared.
+   *
+   * Under FlopsModel, approximations with flops_costs are evaluated in
+   * closed form (see getMinEssentials). Otherwise, those flagged
+   * apprx_fixed_set are evaluated as the cheapest of their candidates, and
+   * the others through solve, whose orders are looked up without
+   * canonicalising them when flagged apprx_canonical (see getIDsFromApprx).
+   * Throws std::invalid_argument if an approximation lacks the function its
+   * flags require.
+   *
+   * @param n               length of the chain.
+   * @param approximations  approximations to evaluate (e.g. the registry).
+   * @param model           cost model (see cost_models.hpp).
+   */
+  template <typename CostModel>
+  ExperimentEngine(const unsigned n,
+                   const std::vector<Approximation>& approximations,
+                   const CostModel& model)
+      : ExperimentEngine(n, approximations) {
+    flops_model = std::is_same<CostModel, FlopsModel>::value;
+    row_cost = [model](std::vector<Algorithm>& A, const Instance& k,
+                       double* row) {
+      for (unsigned i = 0U; i < A.size(); i++)
+        row[i] = A[i].computeCost(k, model);
+    };
+  }
+
+  /**
+   * @brief Evaluates every approximation on every instance in S.
+   *
+   * Instances are processed in blocks whose cost rows stay in cache: the
+   * cost of every parenthesisation is computed for the block, all
+   * approximations are run on it, and one reduceCostMatrix pass gathers the
+   * minima and their costs, whose penalties are accumulated in the running
+   * metrics (see getStats). Replaces building the cost matrix of all the
+   * instances and one getCostFromApprx pass per approximation.
+   *
+   * @param S           instances of length n.
+   * @return EngineBatch
+   */
+  EngineBatch run(const std::vector<Instance>& S);
+
+  // Getters.
+  inline unsigned getNumAlgorithms() const noexcept { return A.size(); }
+  inline const std::vector<Approximation>& getApproximations() const noexcept {
+    return approximations;
+  }
+  // Metrics accumulated over all calls to run, one per approximation.
+  inline const std::vector<PenaltyStats>& getStats() const noexcept {
+    return stats;
+  }
+
+ private:
+  ExperimentEngine(const unsigned n,
+                   const std::vector<Approximation>& approximations);
+
+  /**
+   * @brief Returns the index in A of the order of computation, canonicalising
+   * it first if needed.
+   */
+  unsigned indexOf(const Permutation& perm) const;
+};
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,60 @@
+#include "exact.hpp"
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+double exactSplits(const unsigned* k, const unsigned n, double* cost,
+                   unsigned* split) {
+  return intervalSplits(
+      n,
+      [k](const unsigned i, const unsigned s, const unsigned j) {
+        return static_cast<double>(k[i]) * static_cast<double>(k[j]) * k[s];
+      },
+      cost, split);
+}
+
+void splitsToOrder(const unsigned n, const unsigned* split, unsigned* stack,
+                   unsigned* order) {
+  // The canonical order is the post-order (left, right, root) of the tree.
+  // Visit it as (root, right, left) and write it back to front.
+  const unsigned stride = n + 1U;
+  unsigned top = 0U, pos = n - 1U;
+  stack[top++] = 0U;
+  stack[top++] = n;
+  while (top > 0U) {
+    const unsigned j = stack[--top];
+    const unsigned i = stack[--top];
+    if (j - i < 2U) continue;
+
+    const unsigned s = split[i * stride + j];
+    order[--pos] = s;
+    stack[top++] = i;
+    stack[top++] = s;
+    stack[top++] = s;
+    stack[top++] = j;
+  }
+}
+
+Permutation exact(const Instance& k) {
+  const unsigned n = k.size() - 1U;
+  std::vector<double> cost((n + 1U) * (n + 1U));
+  std::vector<unsigned> split((n + 1U) * (n + 1U));
+  std::vector<unsigned> stack(2U * (n + 1U));
+  Permutation perm(n - 1U);
+
+  exactSplits(k.data(), n, cost.data(), split.data());
+  splitsToOrder(n, split.data(), stack.data(), perm.data());
+  return perm;
+}
+
+double exactCost(const Instance& k) {
+  const unsigned n = k.size() - 1U;
+  std::vector<double> cost((n + 1U) * (n + 1U));
+  std::vector<unsigned> split((n + 1U) * (n + 1U));
+  return exactSplits(k.data(), n, cost.data(), split.data());
+}
+
+}  // namespace mc
@@ -0,0 +1,99 @@
+#ifndef EXACT_H
+#define EXACT_H
+
+#include <limits>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+/**
+ * @brief The interval dynamic programming of exactSplits under any cost of
+ * the multiplications. Does not allocate.
+ *
+ * mult_cost(i, s, j) returns the cost of multiplying the products spanning
+ * dimensions i..s and s..j, which must not depend on how those are
+ * parenthesised. Ties are broken towards the smallest split.
+ *
+ * @param n         length of the chain.
+ * @param mult_cost callable (unsigned, unsigned, unsigned) -> double.
+ * @param cost      workspace of (n+1)^2 doubles, laid out as in exactSplits.
+ * @param split     workspace of (n+1)^2 unsigned, laid out as in exactSplits.
+ * @return double   minimum cost of the whole chain.
+ */
+template <typename MultCost>
+double intervalSplits(const unsigned n, const MultCost& mult_cost,
+                      double* cost, unsigned* split) {
+  const unsigned stride = n + 1U;
+  for (unsigned i = 0U; i < n; i++) cost[i * stride + i + 1U] = 0.0;
+
+  for (unsigned len = 2U; len <= n; len++) {
+    for (unsigned i = 0U; i + len <= n; i++) {
+      const unsigned j = i + len;
+      double best = std::numeric_limits<double>::max();
+      unsigned best_s = i + 1U;
+      for (unsigned s = i + 1U; s < j; s++) {
+        const double c =
+            cost[i * stride + s] + cost[s * stride + j] + mult_cost(i, s, j);
+        if (c < best) {
+          best = c;
+          best_s = s;
+        }
+      }
+      cost[i * stride + j] = best;
+      split[i * stride + j] = best_s;
+    }
+  }
+  return cost[n];
+}
+
+/**
+ * @brief Solves the matrix chain problem exactly with the classic O(n^3)
+ * dynamic programming over intervals. Does not allocate.
+ *
+ * Entries are indexed by the first and last dimension of an interval: on
+ * return, cost[i * (n+1) + j] holds the minimum cost of computing the product
+ * of the matrices spanning dimensions i..j, and split[i * (n+1) + j] the
+ * dimension at which that product is split (for j - i >= 2).
+ *
+ * @param k       pointer to the n+1 dimensions of the chain.
+ * @param n       length of the chain.
+ * @param cost    workspace of (n+1)^2 doubles.
+ * @param split   workspace of (n+1)^2 unsigned.
+ * @return double minimum cost of the whole chain.
+ */
+double exactSplits(const unsigned* k, const unsigned n, double* cost,
+                   unsigned* split);
+
+/**
+ * @brief Writes the canonical order of computation of the parenthesisation
+ * described by a split table (see exactSplits). Does not allocate.
+ *
+ * @param n       length of the chain.
+ * @param split   split table as filled by exactSplits.
+ * @param stack   workspace of 2 * (n+1) unsigned.
+ * @param order   output, n-1 entries.
+ */
+void splitsToOrder(const unsigned n, const unsigned* split, unsigned* stack,
+                   unsigned* order);
+
+/**
+ * @brief Returns an optimal order of computation for the passed instance.
+ *
+ * @param k             Instance.
+ * @return Permutation  Canonical order of an optimal parenthesisation.
+ */
+Permutation exact(const Instance& k);
+
+/**
+ * @brief Returns the minimum cost of the passed instance.
+ *
+ * @param k       Instance.
+ * @return double Cost of an optimal parenthesisation.
+ */
+double exactCost(const Instance& k);
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,136 @@
+#include "executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "definitions.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+constexpr unsigned block_m = 64U;
+constexpr unsigned block_k = 256U;
+constexpr unsigned block_n = 512U;
+
+// Problems below this number of multiply-adds are not worth a thread spawn.
+constexpr double min_work_per_thread = 1 << 18;
+
+// C[row_begin:row_end, :] = A[row_begin:row_end, :] * B.
+void gemmRows(const unsigned row_begin, const unsigned row_end,
+              const unsigned k, const unsigned n, const double* A,
+              const double* B, double* C) {
+  std::fill(C + static_cast<size_t>(row_begin) * n,
+            C + static_cast<size_t>(row_end) * n, 0.0);
+
+  for (unsigned jj = 0U; jj < n; jj += block_n) {
+    const unsigned j_end = std::min(jj + block_n, n);
+    for (unsigned pp = 0U; pp < k; pp += block_k) {
+      const unsigned p_end = std::min(pp + block_k, k);
+      for (unsigned ii = row_begin; ii < row_end; ii += block_m) {
+        const unsigned i_end = std::min(ii + block_m, row_end);
+        for (unsigned i = ii; i < i_end; i++) {
+          double* c_row = C + static_cast<size_t>(i) * n;
+          for (unsigned p = pp; p < p_end; p++) {
+            const double a_ip = A[static_cast<size_t>(i) * k + p];
+            const double* b_row = B + static_cast<size_t>(p) * n;
+            for (unsigned j = jj; j < j_end; j++) c_row[j] += a_ip * b_row[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+struct Step {
+  unsigned left, right, result;  // Indices into the operand buffers.
+  unsigned m, k, n;
+};
+
+}  // namespace
+
+void gemm(const unsigned m, const unsigned k, const unsigned n,
+          const double* A, const double* B, double* C,
+          const unsigned n_threads) {
+  const double work = static_cast<double>(m) * static_cast<double>(k) *
+                      static_cast<double>(n);
+  const unsigned n_useful = static_cast<unsigned>(
+      std::min<double>(m, work / min_work_per_thread));
+  const unsigned n_workers = std::min(n_threads, n_useful);
+  if (n_workers <= 1U) {
+    gemmRows(0U, m, k, n, A, B, C);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(n_workers - 1U);
+  const unsigned rows_per_worker = (m + n_workers - 1U) / n_workers;
+  for (unsigned t = 1U; t < n_workers; t++) {
+    const unsigned row_begin = std::min(t * rows_per_worker, m);
+    const unsigned row_end = std::min(row_begin + rows_per_worker, m);
+    workers.emplace_back(gemmRows, row_begin, row_end, k, n, A, B, C);
+  }
+  gemmRows(0U, std::min(rows_per_worker, m), k, n, A, B, C);
+  for (auto& worker : workers) worker.join();
+}
+
+Executor::Executor(const Instance& instance, const unsigned n_threads)
+    : instance{instance}, n_threads{n_threads} {
+  if (this->n_threads == 0U)
+    this->n_threads = std::max(1U, std::thread::hardware_concurrency());
+
+  inputs.resize(instance.size() - 1U);
+  for (unsigned i = 0U; i + 1U < instance.size(); i++) {
+    inputs[i].resize(static_cast<size_t>(instance[i]) * instance[i + 1U]);
+    for (size_t e = 0U; e < inputs[i].size(); e++)
+      inputs[i][e] = static_cast<double>((e * 7U + i * 13U) % 17U) / 17.0;
+  }
+}
+
+double Executor::run(const Permutation& perm) {
+  const unsigned n = instance.size() - 1U;
+
+  // Resolve the operands of every multiplication; the operand spanning
+  // dimensions [lo, hi] is stored in slot[lo].
+  std::vector<unsigned> slot(n + 1U);
+  for (unsigned i = 0U; i <= n; i++) slot[i] = i;
+
+  std::vector<Step> steps;
+  steps.reserve(perm.size());
+  std::vector<std::vector<double>> intermediates(perm.size());
+  visitOrder(perm, n,
+             [&](const unsigned s, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+               const unsigned result = n + s;
+               steps.push_back({slot[lo], slot[p], result, instance[lo],
+                                instance[p], instance[hi]});
+               intermediates[s].resize(static_cast<size_t>(instance[lo]) *
+                                       instance[hi]);
+               slot[lo] = result;
+             });
+
+  auto buffer = [&](const unsigned id) -> double* {
+    return (id < n) ? inputs[id].data() : intermediates[id - n].data();
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& step : steps) {
+    gemm(step.m, step.k, step.n, buffer(step.left), buffer(step.right),
+         buffer(step.result), n_threads);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double>(end - start).count();
+}
+
+double Executor::measure(const Permutation& perm, const unsigned n_reps) {
+  double best = std::numeric_limits<double>::max();
+  for (unsigned r = 0U; r < n_reps; r++) best = std::min(best, run(perm));
+  return best;
+}
+
+}  // namespace mc
@@ -0,0 +1,75 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+/**
+ * @brief Computes C = A * B for row-major matrices A (m x k) and B (k x n).
+ *
+ * The product is blocked for cache reuse and, for large enough problems, the
+ * rows of C are split across n_threads worker threads.
+ *
+ * @param m         number of rows of A and C.
+ * @param k         number of columns of A and rows of B.
+ * @param n         number of columns of B and C.
+ * @param A         pointer to A.
+ * @param B         pointer to B.
+ * @param C         pointer to C (overwritten).
+ * @param n_threads number of threads to use.
+ */
+void gemm(const unsigned m, const unsigned k, const unsigned n,
+          const double* A, const double* B, double* C,
+          const unsigned n_threads);
+
+class Executor {  // Executes parenthesisations of a chain on the CPU.
+ private:
+  Instance instance;
+  unsigned n_threads;
+  std::vector<std::vector<double>> inputs;  // One matrix per factor.
+
+ public:
+  Executor() = delete;
+
+  /**
+   * @brief Parametrised constructor. Allocates and fills the input matrices.
+   *
+   * @param instance  vector<unsigned> - sizes of the chain.
+   * @param n_threads number of threads used by every multiplication. If 0,
+   * the number of hardware threads is used.
+   */
+  Executor(const Instance& instance, const unsigned n_threads = 0U);
+
+  ~Executor() = default;
+
+  /**
+   * @brief Executes the passed parenthesisation once.
+   *
+   * Intermediates are allocated before the clock starts, so only the
+   * multiplications are timed. Throws std::invalid_argument if perm is not
+   * an order of computation for the instance.
+   *
+   * @param perm      order of computation.
+   * @return double   elapsed time in seconds.
+   */
+  double run(const Permutation& perm);
+
+  /**
+   * @brief Executes the passed parenthesisation n_reps times.
+   *
+   * @param perm      order of computation.
+   * @param n_reps    number of repetitions.
+   * @return double   minimum elapsed time in seconds across repetitions.
+   */
+  double measure(const Permutation& perm, const unsigned n_reps);
+
+  // Getter for the number of threads.
+  inline unsigned getNumThreads() const noexcept { return n_threads; }
+};
+
+}  // namespace mc
+
+#endif
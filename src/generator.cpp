@@ -1,7 +1,10 @@
 #include "generator.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 #include "algorithm.hpp"
@@ -11,7 +14,7 @@
 namespace mc {
 
 std::vector<Algorithm> generateAlgorithms(const unsigned n) {
-  unsigned n_algs = catalanNumber(n - 1U);
+  const uint64_t n_algs = catalanNumber(n - 1U);
   std::vector<Algorithm> algorithms;
   algorithms.reserve(n_algs);
 
@@ -64,16 +67,30 @@ std::vector<unsigned> getIDs(const std::vector<Algorithm>& algs,
   return IDs;
 }
 
-unsigned factorial(const unsigned n) {
-  unsigned fact = 1U;
+uint64_t factorial(const unsigned n) {
+  if (n > 20U) throw std::overflow_error("factorial: n! exceeds 64 bits");
+  uint64_t fact = 1U;
   for (unsigned i = 2U; i <= n; i++) {
     fact *= i;
   }
   return fact;
 }
 
-unsigned catalanNumber(const unsigned n) {
-  return factorial(2 * n) / (factorial(n + 1) * factorial(n));
+uint64_t catalanNumber(const unsigned n) {
+  // C_{i+1} = C_i * 2(2i+1) / (i+2). The division is exact, so dividing the
+  // common factors out first keeps every intermediate below the result.
+  uint64_t catalan = 1U;
+  for (uint64_t i = 0U; i < n; i++) {
+    uint64_t num = 2U * (2U * i + 1U), den = i + 2U;
+    const uint64_t g = std::gcd(catalan, den);
+    catalan /= g;
+    den /= g;
+    num /= den;  // den now divides num.
+    if (catalan > std::numeric_limits<uint64_t>::max() / num)
+      throw std::overflow_error("catalanNumber: C_n exceeds 64 bits");
+    catalan *= num;
+  }
+  return catalan;
 }
 
 bool isCanonical(const Permutation& perm) {
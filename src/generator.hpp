@@ -1,6 +1,8 @@
 #ifndef GENERATOR_H
 #define GENERATOR_H
 
+#include <cstdint>
+
 #include "algorithm.hpp"
 #include "definitions.hpp"
 
@@ -52,20 +54,21 @@ std::vector<unsigned> getIDs(const std::vector<Algorithm>& algs,
                              const std::vector<Permutation>& perms);
 
 /**
- * @brief Computes the factorial of n.
+ * @brief Computes the factorial of n. Throws std::overflow_error for n > 20.
  *
  * @param n
- * @return unsigned
+ * @return uint64_t
  */
-unsigned factorial(const unsigned n);
+uint64_t factorial(const unsigned n);
 
 /**
- * @brief Computes the nth Calatan number.
+ * @brief Computes the nth Calatan number without going through factorials.
+ * Throws std::overflow_error for n > 36.
  *
  * @param n
- * @return unsigned
+ * @return uint64_t
  */
-unsigned catalanNumber(const unsigned n);
+uint64_t catalanNumber(const unsigned n);
 
 /**
  * @brief Checks whether a permutation is in canonical form.
@@ -0,0 +1,84 @@
+#include "incremental.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+IncrementalPlanner::IncrementalPlanner(const Instance& k) {
+  reserve(k.empty() ? 0U : k.size() - 1U);
+  for (const auto& dim : k) push(dim);
+}
+
+void IncrementalPlanner::push(const unsigned dim) {
+  k.push_back(dim);
+  const unsigned j = k.size() - 1U;
+  if (j == 0U) return;
+  cost.resize(at(0U, j + 1U));
+  split.resize(at(0U, j + 1U));
+
+  // Shorter intervals first, with the same tie-breaking as exactSplits.
+  cost[at(j - 1U, j)] = 0.0;
+  for (unsigned i = j - 1U; i-- > 0U;) {
+    const double k_ij = static_cast<double>(k[i]) * static_cast<double>(k[j]);
+    double best = std::numeric_limits<double>::max();
+    unsigned best_s = i + 1U;
+    for (unsigned s = i + 1U; s < j; s++) {
+      const double c = cost[at(i, s)] + cost[at(s, j)] + k_ij * k[s];
+      if (c < best) {
+        best = c;
+        best_s = s;
+      }
+    }
+    cost[at(i, j)] = best;
+    split[at(i, j)] = best_s;
+  }
+}
+
+void IncrementalPlanner::pop() {
+  if (k.empty()) throw std::length_error("IncrementalPlanner: empty chain");
+  const unsigned j = k.size() - 1U;
+  k.pop_back();
+  if (j == 0U) return;
+  cost.resize(at(0U, j));
+  split.resize(at(0U, j));
+}
+
+void IncrementalPlanner::reserve(const unsigned max_n) {
+  k.reserve(max_n + 1U);
+  cost.reserve(at(0U, max_n + 1U));
+  split.reserve(at(0U, max_n + 1U));
+}
+
+Permutation IncrementalPlanner::getPlan() const {
+  const unsigned n = getLength();
+  if (n < 2U) return {};
+
+  // Post-order (left, right, root), visited as (root, right, left) and
+  // written back to front, as in splitsToOrder.
+  Permutation order(n - 1U);
+  std::vector<unsigned> stack{0U, n};
+  unsigned pos = n - 1U;
+  while (!stack.empty()) {
+    const unsigned j = stack.back();
+    stack.pop_back();
+    const unsigned i = stack.back();
+    stack.pop_back();
+    if (j - i < 2U) continue;
+
+    const unsigned s = split[at(i, j)];
+    order[--pos] = s;
+    stack.insert(stack.end(), {i, s, s, j});
+  }
+  return order;
+}
+
+double IncrementalPlanner::getCost() const noexcept {
+  const unsigned n = getLength();
+  return n < 2U ? 0.0 : cost[at(0U, n)];
+}
+
+}  // namespace mc
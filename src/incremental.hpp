@@ -0,0 +1,89 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <cstddef>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Exact planner for a chain built one factor at a time. The DP table is
+// stored by columns: column j holds the intervals i..j ending at dimension j,
+// which do not change when dimensions are appended after j. Appending a
+// dimension thus only computes its column, in O(n^2), and removing the last
+// one drops it.
+class IncrementalPlanner {
+ private:
+  Instance k;
+  std::vector<double> cost;     // Entry (i, j) at j * (j-1) / 2 + i, i < j.
+  std::vector<unsigned> split;  // Same layout, for j - i >= 2.
+
+ public:
+  IncrementalPlanner() = default;
+
+  /**
+   * @brief Parametrised constructor. Appends the dimensions of the instance
+   * one by one, in O(n^3) overall.
+   *
+   * @param k   Instance.
+   */
+  explicit IncrementalPlanner(const Instance& k);
+
+  ~IncrementalPlanner() = default;
+
+  /**
+   * @brief Appends a dimension, i.e. a factor whose rows are the columns of
+   * the last one (the first dimension only sets the rows of the first factor).
+   * Runs in O(n^2).
+   *
+   * @param dim   dimension to append.
+   */
+  void push(const unsigned dim);
+
+  /**
+   * @brief Removes the last dimension. Runs in O(1).
+   *
+   * Throws std::length_error if there are no dimensions.
+   */
+  void pop();
+
+  /**
+   * @brief Allocates the table for chains of up to max_n matrices, so that
+   * push does not reallocate until then.
+   *
+   * @param max_n   length of the chain.
+   */
+  void reserve(const unsigned max_n);
+
+  /**
+   * @brief Returns the canonical order of an optimal parenthesisation of the
+   * current chain, the same as exact. Runs in O(n).
+   *
+   * @return Permutation  empty for chains of fewer than two matrices.
+   */
+  Permutation getPlan() const;
+
+  /**
+   * @brief Returns the cost of an optimal parenthesisation of the current
+   * chain. Runs in O(1).
+   *
+   * @return double   0 for chains of fewer than two matrices.
+   */
+  double getCost() const noexcept;
+
+  // Getters for the current chain.
+  inline const Instance& getInstance() const noexcept { return k; }
+  inline unsigned getLength() const noexcept {
+    return k.empty() ? 0U : k.size() - 1U;
+  }
+
+ private:
+  static inline std::size_t at(const unsigned i, const unsigned j) noexcept {
+    return static_cast<std::size_t>(j) * (j - 1U) / 2U + i;
+  }
+};
+
+}  // namespace mc
+
+#endif
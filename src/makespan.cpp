@@ -0,0 +1,149 @@
+#include "makespan.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "definitions.hpp"
+#include "exact.hpp"
+#include "pareto_front.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+constexpr unsigned no_parent = ~0U;
+
+// Multiplication s of perm: its FLOPs and the multiplication reading its
+// result, which always comes later in the order.
+struct TaskTree {
+  std::vector<double> flops;
+  std::vector<unsigned> parent, n_children;  // Intermediate children only.
+};
+
+TaskTree buildTaskTree(const Permutation& perm, const Instance& k) {
+  if (k.size() < 2U or perm.size() + 2U != k.size())
+    throw std::invalid_argument("Permutation does not match the instance");
+  const unsigned n = k.size() - 1U;
+
+  // task[lo] is the multiplication producing the operand that starts at
+  // dimension lo.
+  std::vector<unsigned> task(n + 1U, no_parent);
+  TaskTree tree;
+  tree.flops.resize(perm.size());
+  tree.parent.assign(perm.size(), no_parent);
+  tree.n_children.assign(perm.size(), 0U);
+  visitOrder(perm, n,
+             [&](const unsigned s, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+               tree.flops[s] = static_cast<double>(k[lo]) * k[p] * k[hi];
+               for (const auto& child : {task[lo], task[p]}) {
+                 if (child == no_parent) continue;
+                 tree.parent[child] = s;
+                 tree.n_children[s]++;
+               }
+               task[lo] = s;
+             });
+  return tree;
+}
+
+// Per task, the FLOPs from its start to the end of the root.
+std::vector<double> bottomLevels(const TaskTree& tree) {
+  std::vector<double> level(tree.flops);
+  for (unsigned s = tree.flops.size(); s-- > 0U;)
+    if (tree.parent[s] != no_parent) level[s] += level[tree.parent[s]];
+  return level;
+}
+
+double scheduleTasks(const TaskTree& tree, const unsigned n_workers) {
+  const std::vector<double> level = bottomLevels(tree);
+  std::vector<unsigned> pending(tree.n_children);
+
+  std::priority_queue<std::pair<double, unsigned>> ready;  // By bottom level.
+  std::priority_queue<std::pair<double, unsigned>,
+                      std::vector<std::pair<double, unsigned>>,
+                      std::greater<>>
+      running;  // By finish time.
+  for (unsigned s = 0U; s < tree.flops.size(); s++)
+    if (pending[s] == 0U) ready.push({level[s], s});
+
+  double time = 0.0;
+  while (!ready.empty() or !running.empty()) {
+    while (!ready.empty() and running.size() < n_workers) {
+      const unsigned s = ready.top().second;
+      ready.pop();
+      running.push({time + tree.flops[s], s});
+    }
+    const auto [finish, s] = running.top();
+    running.pop();
+    time = finish;
+    const unsigned parent = tree.parent[s];
+    if (parent != no_parent and --pending[parent] == 0U)
+      ready.push({level[parent], parent});
+  }
+  return time;
+}
+
+}  // namespace
+
+double criticalPath(const Permutation& perm, const Instance& k) {
+  const std::vector<double> level = bottomLevels(buildTaskTree(perm, k));
+  return level.empty() ? 0.0 : *std::max_element(level.begin(), level.end());
+}
+
+double listMakespan(const Permutation& perm, const Instance& k,
+                    const unsigned n_workers) {
+  if (n_workers == 0U)
+    throw std::invalid_argument("listMakespan: no workers");
+  return scheduleTasks(buildTaskTree(perm, k), n_workers);
+}
+
+ParallelPlan planMakespan(const Instance& k, const unsigned n_workers,
+                          const unsigned max_front) {
+  if (k.size() < 3U or n_workers == 0U or max_front < 2U)
+    throw std::invalid_argument("planMakespan: invalid parameters");
+  const unsigned n = k.size() - 1U;
+
+  ParallelPlan best;
+  best.permutation = exact(k);
+  best.flops = permutationFlops(best.permutation, k);
+  best.critical_path = criticalPath(best.permutation, k);
+  best.makespan = listMakespan(best.permutation, k, n_workers);
+  if (n_workers == 1U) return best;
+
+  // Fronts of (FLOPs, critical path), without the pairs that cannot beat the
+  // FLOP-optimal tree.
+  const auto fronts = paretoFronts(
+      k,
+      [&k](const unsigned i, const unsigned s, const unsigned j,
+           const FrontEntry& l, const FrontEntry& r) {
+        const double mult = static_cast<double>(k[i]) * k[s] * k[j];
+        return std::make_pair(std::max(l.cost, r.cost) + mult, true);
+      },
+      [&](const double flops, const double path) {
+        return std::max(path, flops / n_workers) <= best.makespan;
+      },
+      max_front);
+
+  // List-schedule the trees on the front of the whole chain.
+  for (unsigned idx = 0U; idx < fronts[n].size(); idx++) {
+    const FrontEntry& root = fronts[n][idx];
+    const Permutation perm = frontOrder(fronts, n, idx);
+    const double makespan = listMakespan(perm, k, n_workers);
+    if (makespan < best.makespan or
+        (makespan == best.makespan and root.flops < best.flops)) {
+      best.permutation = perm;
+      best.flops = root.flops;
+      best.critical_path = root.cost;
+      best.makespan = makespan;
+    }
+  }
+  return best;
+}
+
+}  // namespace mc
@@ -0,0 +1,77 @@
+#ifndef MAKESPAN_H
+#define MAKESPAN_H
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Parallel execution model: independent multiplications run concurrently, one
+// per worker, and a multiplication takes as long as its FLOPs.
+
+struct ParallelPlan {
+  Permutation permutation;  // Canonical order of computation.
+  double flops{0.0};
+  double critical_path{0.0};  // FLOPs along the longest dependency chain.
+  double makespan{0.0};       // List-scheduled on the requested workers.
+};
+
+/**
+ * @brief Returns the critical path of the parenthesisation: the largest sum
+ * of FLOPs along a path from a multiplication to the root. Runs in O(n).
+ *
+ * Throws std::invalid_argument if the permutation is not an order of
+ * computation for the instance.
+ *
+ * @param perm    order of computation.
+ * @param k       Instance.
+ * @return double
+ */
+double criticalPath(const Permutation& perm, const Instance& k);
+
+/**
+ * @brief Returns the makespan of the parenthesisation list-scheduled on
+ * n_workers workers, ready multiplications being started by decreasing
+ * bottom level (critical path to the root). Runs in O(n log n).
+ *
+ * By Graham's bound, it is at most flops / n_workers + critical path. Throws
+ * std::invalid_argument if the permutation is not an order of computation or
+ * n_workers is 0.
+ *
+ * @param perm      order of computation (its tree is what matters).
+ * @param k         Instance.
+ * @param n_workers number of workers.
+ * @return double
+ */
+double listMakespan(const Permutation& perm, const Instance& k,
+                    const unsigned n_workers);
+
+/**
+ * @brief Returns the parenthesisation with the least list-scheduled makespan
+ * on n_workers among the candidates of a DP over intervals.
+ *
+ * Every interval keeps its non-dominated (FLOPs, critical path) pairs. Both
+ * only grow with those of the operands, so the front of the whole chain holds
+ * the tree minimising any estimate increasing in both, such as
+ * max(critical path, FLOPs / n_workers). Pairs whose lower bound
+ * max(critical path, FLOPs / n_workers) already exceeds the makespan of the
+ * FLOP-optimal tree are pruned, and fronts longer than max_front are thinned
+ * to max_front evenly spaced entries (keeping both ends), which bounds the
+ * cost by O(n^3 max_front^2) at the price of exactness on long chains. The
+ * front's trees and the FLOP-optimal one are list-scheduled and the fastest
+ * is returned (fewest FLOPs on ties), so it is never slower than the
+ * FLOP-optimal tree. With one worker, it is the FLOP-optimal tree.
+ *
+ * Throws std::invalid_argument if the instance has fewer than three
+ * dimensions, n_workers is 0 or max_front < 2.
+ *
+ * @param k             Instance.
+ * @param n_workers     number of workers.
+ * @param max_front     maximum number of pairs kept per interval.
+ * @return ParallelPlan
+ */
+ParallelPlan planMakespan(const Instance& k, const unsigned n_workers,
+                          const unsigned max_front = 16U);
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,216 @@
+#include "memory_plan.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "definitions.hpp"
+#include "pareto_front.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+// Peak of a product whose operands peak at (and then hold) the given bytes,
+// evaluating the left operand first or not.
+inline double combinedPeak(const double peak_l, const double size_l,
+                           const double peak_r, const double size_r,
+                           const double size, const bool left_first) {
+  const double during = size_l + size_r + size;
+  return left_first ? std::max({peak_l, size_l + peak_r, during})
+                    : std::max({peak_r, size_r + peak_l, during});
+}
+
+// Operand node per starting dimension of the tree of perm: ids 0..n-1 are the
+// inputs, n + s the result of the s-th multiplication.
+struct PermTree {
+  std::vector<unsigned> left, right, lo, hi;  // Per multiplication.
+};
+
+PermTree buildPermTree(const Permutation& perm, const Instance& k) {
+  if (k.size() < 2U or perm.size() + 2U != k.size())
+    throw std::invalid_argument("Permutation does not match the instance");
+  const unsigned n = k.size() - 1U;
+
+  std::vector<unsigned> op(n + 1U);
+  for (unsigned i = 0U; i <= n; i++) op[i] = i;
+  PermTree tree;
+  visitOrder(perm, n,
+             [&](const unsigned s, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+               tree.left.push_back(op[lo]);
+               tree.right.push_back(op[p]);
+               tree.lo.push_back(lo);
+               tree.hi.push_back(hi);
+               op[lo] = n + s;
+             });
+  return tree;
+}
+
+// Fronts of (FLOPs, peak) over intervals, with the peak of the best
+// post-order (one operand finished before the other is started).
+std::vector<std::vector<FrontEntry>> memoryFronts(const Instance& k,
+                                                  const unsigned eb) {
+  auto bytes = [&](const unsigned i, const unsigned j) {
+    return (j - i >= 2U) ? static_cast<double>(eb) * k[i] * k[j] : 0.0;
+  };
+  return paretoFronts(
+      k,
+      [&](const unsigned i, const unsigned s, const unsigned j,
+          const FrontEntry& l, const FrontEntry& r) {
+        const double size_l = bytes(i, s), size_r = bytes(s, j),
+                     size = static_cast<double>(eb) * k[i] * k[j];
+        const double left_first =
+            combinedPeak(l.cost, size_l, r.cost, size_r, size, true);
+        const double right_first =
+            combinedPeak(l.cost, size_l, r.cost, size_r, size, false);
+        return std::make_pair(std::min(left_first, right_first),
+                              left_first <= right_first);
+      },
+      [](double, double) { return true; });
+}
+
+// A run of a schedule that rises from the previous valley to its hill (the
+// peak bytes while it runs) and ends at its valley, the bytes it leaves.
+struct Segment {
+  double hill, valley;
+  std::vector<unsigned> steps;  // Indices into the permutation.
+};
+
+struct Point {  // Peak and bytes after a step of a schedule.
+  double peak, after;
+  const std::vector<unsigned>* steps;
+};
+
+// Splits a schedule into hill-valley segments: the first hill is the highest
+// peak, its valley the least bytes after it, the next hill the highest peak
+// after that valley, and so on (ties going to the last occurrence). Hills
+// decrease and valleys increase, so hill - valley decreases.
+std::vector<Segment> hillValleySegments(const std::vector<Point>& points) {
+  const unsigned L = points.size();
+  std::vector<unsigned> max_peak(L), min_after(L);  // Over [i, L).
+  for (unsigned i = L; i-- > 0U;) {
+    const bool last = i + 1U == L;
+    max_peak[i] = (last or points[i].peak > points[max_peak[i + 1U]].peak)
+                      ? i
+                      : max_peak[i + 1U];
+    min_after[i] = (last or points[i].after < points[min_after[i + 1U]].after)
+                       ? i
+                       : min_after[i + 1U];
+  }
+  std::vector<Segment> segments;
+  for (unsigned i = 0U; i < L;) {
+    const unsigned hill = max_peak[i], valley = min_after[hill];
+    Segment seg{points[hill].peak, points[valley].after, {}};
+    for (; i <= valley; i++)
+      seg.steps.insert(seg.steps.end(), points[i].steps->begin(),
+                       points[i].steps->end());
+    segments.push_back(std::move(seg));
+  }
+  return segments;
+}
+
+}  // namespace
+
+double peakMemory(const Permutation& perm, const Instance& k,
+                  const unsigned element_bytes) {
+  const unsigned n = k.size() - 1U;
+  const PermTree tree = buildPermTree(perm, k);
+  double live = 0.0, peak = 0.0;
+  for (unsigned s = 0U; s < perm.size(); s++) {
+    const double size =
+        static_cast<double>(element_bytes) * k[tree.lo[s]] * k[tree.hi[s]];
+    live += size;
+    peak = std::max(peak, live);
+    for (const auto& operand : {tree.left[s], tree.right[s]}) {
+      if (operand >= n) {
+        const unsigned t = operand - n;
+        live -= static_cast<double>(element_bytes) * k[tree.lo[t]] *
+                k[tree.hi[t]];
+      }
+    }
+  }
+  return peak;
+}
+
+Permutation minMemoryOrder(const Permutation& perm, const Instance& k) {
+  const unsigned n = k.size() - 1U;
+  const PermTree tree = buildPermTree(perm, k);
+  if (perm.empty()) return {};
+
+  // Liu's algorithm: the least-peak schedule of every subtree is kept as its
+  // hill-valley segments, the schedules of both operands are merged by
+  // decreasing hill - valley, and the multiplication is appended.
+  std::vector<std::vector<Segment>> segments(2U * n - 1U);
+  std::vector<double> size(2U * n - 1U, 0.0);
+  std::vector<Point> points;
+  for (unsigned s = 0U; s < perm.size(); s++) {
+    const unsigned v = n + s;
+    size[v] = static_cast<double>(k[tree.lo[s]]) * k[tree.hi[s]];
+    auto& l = segments[tree.left[s]];
+    auto& r = segments[tree.right[s]];
+
+    // Memory after every segment (or the multiplication) of the new schedule.
+    points.clear();
+    double base = 0.0, valley_l = 0.0, valley_r = 0.0;
+    for (unsigned a = 0U, b = 0U; a < l.size() or b < r.size();) {
+      const bool take_l =
+          b == r.size() or (a < l.size() and l[a].hill - l[a].valley >=
+                                                 r[b].hill - r[b].valley);
+      Segment& seg = take_l ? l[a++] : r[b++];
+      double& valley = take_l ? valley_l : valley_r;
+      points.push_back({base - valley + seg.hill, base - valley + seg.valley,
+                        &seg.steps});
+      base += seg.valley - valley;
+      valley = seg.valley;
+    }
+    const std::vector<unsigned> own{s};
+    points.push_back({base + size[v], size[v], &own});
+    segments[v] = hillValleySegments(points);
+    l.clear();
+    r.clear();
+  }
+
+  Permutation order;
+  order.reserve(perm.size());
+  for (const auto& seg : segments[2U * n - 2U])
+    for (const auto& s : seg.steps) order.push_back(perm[s]);
+  return order;
+}
+
+std::vector<MemoryPlan> flopsMemoryFront(const Instance& k,
+                                         const unsigned element_bytes) {
+  if (k.size() < 3U)
+    throw std::invalid_argument("flopsMemoryFront: chain too short");
+  const unsigned n = k.size() - 1U;
+  const auto fronts = memoryFronts(k, element_bytes);
+
+  // Rescheduling lowers some peaks, which can dominate later entries.
+  std::vector<MemoryPlan> plans;
+  for (unsigned idx = 0U; idx < fronts[n].size(); idx++) {
+    MemoryPlan plan;
+    plan.flops = fronts[n][idx].flops;
+    plan.permutation = minMemoryOrder(frontOrder(fronts, n, idx), k);
+    plan.peak_bytes = peakMemory(plan.permutation, k, element_bytes);
+    if (plans.empty() or plan.peak_bytes < plans.back().peak_bytes)
+      plans.push_back(std::move(plan));
+  }
+  return plans;
+}
+
+MemoryPlan planUnderMemory(const Instance& k, const double memory_cap,
+                           const unsigned element_bytes) {
+  if (k.size() < 3U)
+    throw std::invalid_argument("planUnderMemory: chain too short");
+  std::vector<MemoryPlan> front = flopsMemoryFront(k, element_bytes);
+  for (auto& plan : front)
+    if (plan.peak_bytes <= memory_cap) return std::move(plan);
+
+  MemoryPlan plan = std::move(front.back());
+  plan.feasible = false;
+  return plan;
+}
+
+}  // namespace mc
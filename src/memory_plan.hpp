@@ -0,0 +1,112 @@
+#ifndef MEMORY_PLAN_H
+#define MEMORY_PLAN_H
+
+#include <vector>
+
+#include "algorithm.hpp"
+#include "definitions.hpp"
+
+namespace mc {
+
+// Memory is accounted for intermediates only: the inputs are alive
+// throughout. A multiplication allocates its result while its operands are
+// still alive, and the intermediate operands are freed once it is done.
+
+struct MemoryPlan {
+  Permutation permutation;  // Order of computation (not canonical in general).
+  double flops{0.0};
+  double peak_bytes{0.0};   // Peak bytes of live intermediates.
+  bool feasible{true};      // Whether it fits in the requested cap.
+};
+
+/**
+ * @brief Returns the peak number of bytes held by live intermediates when
+ * executing the multiplications in the order of the permutation.
+ *
+ * Runs in O(n). Throws std::invalid_argument if the permutation is not an
+ * order of computation for the instance.
+ *
+ * @param perm          order of computation, not necessarily canonical.
+ * @param k             Instance.
+ * @param element_bytes bytes per matrix entry.
+ * @return double
+ */
+double peakMemory(const Permutation& perm, const Instance& k,
+                  const unsigned element_bytes = 8U);
+
+/**
+ * @brief Returns the peak number of bytes held by live intermediates when
+ * executing the algorithm in its order of computation.
+ */
+template <typename Index>
+double peakMemory(const BasicAlgorithm<Index>& algorithm, const Instance& k,
+                  const unsigned element_bytes = 8U) {
+  return peakMemory(algorithm.getPermutation(), k, element_bytes);
+}
+
+/**
+ * @brief Reorders the multiplications of the permutation's tree to minimise
+ * the peak memory of live intermediates.
+ *
+ * Liu's algorithm for general orders (Liu 1987, "An application of generalized
+ * tree pebbling to sparse matrix factorization"): the schedule of every
+ * subtree is split into hill-valley segments, and the segments of the two
+ * operands are interleaved by decreasing hill - valley. This gives the least
+ * peak among all the orders of the tree, including those that do not finish
+ * a subtree before starting its sibling. The tree, and hence the FLOPs, are
+ * unchanged. Runs in O(n^2) in the worst case. Throws std::invalid_argument
+ * if the permutation is not an order of computation.
+ *
+ * @param perm          order of computation.
+ * @param k             Instance.
+ * @return Permutation  reordered order of computation.
+ */
+Permutation minMemoryOrder(const Permutation& perm, const Instance& k);
+
+/**
+ * @brief Returns the Pareto front of (FLOPs, peak memory) over all the
+ * parenthesisations, each scheduled with minMemoryOrder, sorted by increasing
+ * FLOPs (and so decreasing peak).
+ *
+ * DP over intervals keeping the non-dominated (FLOPs, peak) pairs of every
+ * interval, with the peak of the best post-order (one operand finished before
+ * the other is started): the peak of a product only grows with the peaks of
+ * its operands, so dominated pairs never lead to a front entry. The trees of
+ * the front are then rescheduled with minMemoryOrder and the entries this
+ * makes dominated are dropped.
+ *
+ * The front is exact among post-order schedules only: a tree that is on the
+ * front of general schedules solely thanks to interleaving its operands can
+ * be missed. Every peak reported is that of the returned order. The first
+ * entry is the FLOP-optimal tree, the last the least peak found. Its cost
+ * grows with the square of the fronts' sizes on top of the O(n^3) of the
+ * plain DP.
+ *
+ * @param k             Instance with at least three dimensions.
+ * @param element_bytes bytes per matrix entry.
+ * @return std::vector<MemoryPlan>
+ */
+std::vector<MemoryPlan> flopsMemoryFront(const Instance& k,
+                                         const unsigned element_bytes = 8U);
+
+/**
+ * @brief Returns the parenthesisation with the fewest FLOPs whose peak memory
+ * of live intermediates does not exceed the cap.
+ *
+ * Returns the first entry of flopsMemoryFront that fits, so it is optimal
+ * among the trees of that front and shares its limitation: a tree that only
+ * fits when its operands are interleaved, and is not on the post-order
+ * front, is not considered. If no entry fits, returns the one with the least
+ * peak with feasible set to false.
+ *
+ * @param k             Instance with at least three dimensions.
+ * @param memory_cap    bytes available for intermediates.
+ * @param element_bytes bytes per matrix entry.
+ * @return MemoryPlan
+ */
+MemoryPlan planUnderMemory(const Instance& k, const double memory_cap,
+                           const unsigned element_bytes = 8U);
+
+}  // namespace mc
+
+#endif
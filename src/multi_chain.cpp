@@ -0,0 +1,228 @@
+#include "multi_chain.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "exact.hpp"
+#include "planner.hpp"
+
+namespace mc {
+
+namespace {
+
+struct Product {  // A distinct run of two or more factors.
+  unsigned chain, first, last;  // Where it appears first: chain[first, last).
+  unsigned rows, cols;
+  unsigned n_occurrences{0U};  // Across all chains.
+  unsigned split{0U};          // Chosen split: [first, split) [split, last).
+};
+
+// A DAG built from the products' splits: its steps in slot order and the
+// slot of every materialised node.
+struct Dag {
+  std::vector<unsigned> node_of_step;  // Node ids (F + product) per step.
+  std::vector<unsigned> uses;          // Per product, number of readers.
+  double cost{0.0};
+};
+
+}  // namespace
+
+MultiChainPlan planChains(const std::vector<Factor>& factors,
+                          const std::vector<std::vector<std::string>>& chains,
+                          const unsigned n_rounds) {
+  const unsigned F = factors.size();
+  std::unordered_map<std::string, unsigned> factor_id;
+  for (unsigned f = 0U; f < F; f++) factor_id[factors[f].name] = f;
+
+  std::vector<std::vector<unsigned>> seqs(chains.size());
+  for (unsigned c = 0U; c < chains.size(); c++) {
+    if (chains[c].empty())
+      throw std::invalid_argument("planChains: empty chain");
+    for (const auto& name : chains[c]) {
+      auto it = factor_id.find(name);
+      if (it == factor_id.end())
+        throw std::invalid_argument("planChains: unknown factor " + name);
+      if (!seqs[c].empty() and
+          factors[seqs[c].back()].cols != factors[it->second].rows)
+        throw std::invalid_argument("planChains: mismatching dimensions at " +
+                                    name);
+      seqs[c].push_back(it->second);
+    }
+  }
+
+  // Node of every interval [i, j) of every chain: the factor for j = i + 1,
+  // F + the index of the distinct product otherwise. Products are numbered by
+  // increasing length, so children always come first.
+  std::vector<Product> products;
+  std::vector<std::vector<unsigned>> node(chains.size());
+  auto at = [&](const unsigned c, const unsigned i, const unsigned j) {
+    return (i * (seqs[c].size() + 1U)) + j;
+  };
+  unsigned max_len = 0U;
+  for (const auto& seq : seqs)
+    max_len = std::max<unsigned>(max_len, seq.size());
+  std::map<std::vector<unsigned>, unsigned> product_id;
+  for (unsigned c = 0U; c < seqs.size(); c++) {
+    const unsigned L = seqs[c].size();
+    node[c].assign((L + 1U) * (L + 1U), 0U);
+    for (unsigned i = 0U; i < L; i++) node[c][at(c, i, i + 1U)] = seqs[c][i];
+  }
+  for (unsigned len = 2U; len <= max_len; len++) {
+    for (unsigned c = 0U; c < seqs.size(); c++) {
+      const unsigned L = seqs[c].size();
+      for (unsigned i = 0U; i + len <= L; i++) {
+        std::vector<unsigned> key(seqs[c].begin() + i,
+                                  seqs[c].begin() + i + len);
+        auto [it, inserted] = product_id.emplace(key, products.size());
+        if (inserted) {
+          products.push_back({c, i, i + len, factors[seqs[c][i]].rows,
+                              factors[seqs[c][i + len - 1U]].cols});
+        }
+        products[it->second].n_occurrences++;
+        node[c][at(c, i, i + len)] = F + it->second;
+      }
+    }
+  }
+  const unsigned P = products.size();
+
+  auto rowsOf = [&](const unsigned id) {
+    return id < F ? factors[id].rows : products[id - F].rows;
+  };
+  auto colsOf = [&](const unsigned id) {
+    return id < F ? factors[id].cols : products[id - F].cols;
+  };
+  auto children = [&](const Product& p, const unsigned s) {
+    return std::make_pair(node[p.chain][at(p.chain, p.first, s)],
+                          node[p.chain][at(p.chain, s, p.last)]);
+  };
+  auto multCost = [&](const Product& p, const unsigned s) {
+    const unsigned l = children(p, s).first;
+    return static_cast<double>(p.rows) * static_cast<double>(colsOf(l)) *
+           static_cast<double>(p.cols);
+  };
+
+  // Materialises the products needed by the chains, children first.
+  auto buildDag = [&]() {
+    Dag dag;
+    dag.uses.assign(P, 0U);
+    std::vector<bool> done(P, false);
+    std::vector<std::pair<unsigned, bool>> stack;  // (node, expanded).
+    for (unsigned c = 0U; c < seqs.size(); c++) {
+      const unsigned root = node[c][at(c, 0U, seqs[c].size())];
+      if (root >= F) dag.uses[root - F]++;
+      stack.assign(1U, {root, false});
+      while (!stack.empty()) {
+        const auto [id, expanded] = stack.back();
+        stack.pop_back();
+        if (id < F or done[id - F]) continue;
+        const Product& p = products[id - F];
+        const auto [l, r] = children(p, p.split);
+        if (expanded) {
+          done[id - F] = true;
+          dag.node_of_step.push_back(id);
+          dag.cost += multCost(p, p.split);
+          if (l >= F) dag.uses[l - F]++;
+          if (r >= F) dag.uses[r - F]++;
+          continue;
+        }
+        stack.push_back({id, true});
+        stack.push_back({r, false});
+        stack.push_back({l, false});
+      }
+    }
+    return dag;
+  };
+
+  // DP over the distinct products with amortised costs.
+  std::vector<double> weight(P, 1.0), f(P);
+  std::vector<unsigned> best_split(P);
+  double best_cost = std::numeric_limits<double>::max();
+  for (unsigned round = 0U; round < std::max(1U, n_rounds); round++) {
+    for (unsigned q = 0U; q < P; q++) {
+      Product& p = products[q];
+      double best = std::numeric_limits<double>::max();
+      for (unsigned s = p.first + 1U; s < p.last; s++) {
+        const auto [l, r] = children(p, s);
+        const double c = (l < F ? 0.0 : f[l - F]) + (r < F ? 0.0 : f[r - F]) +
+                         weight[q] * multCost(p, s);
+        if (c < best) {
+          best = c;
+          p.split = s;
+        }
+      }
+      f[q] = best;
+    }
+
+    const Dag dag = buildDag();
+    if (dag.cost < best_cost) {
+      best_cost = dag.cost;
+      for (unsigned q = 0U; q < P; q++) best_split[q] = products[q].split;
+    }
+
+    for (unsigned q = 0U; q < P; q++) {
+      const unsigned n_uses = (round == 0U) ? 0U : dag.uses[q];
+      weight[q] = 1.0 / std::max(1U, n_uses > 0U ? n_uses
+                                                 : products[q].n_occurrences);
+    }
+  }
+  for (unsigned q = 0U; q < P; q++) products[q].split = best_split[q];
+
+  // Local search on the true cost: re-split one materialised product at a
+  // time while that makes the DAG cheaper.
+  bool improved = true;
+  for (unsigned pass = 0U; improved and pass < std::max(1U, n_rounds);
+       pass++) {
+    improved = false;
+    const std::vector<unsigned> materialised = buildDag().node_of_step;
+    for (const auto& id : materialised) {
+      Product& p = products[id - F];
+      const unsigned current = p.split;
+      for (unsigned s = p.first + 1U; s < p.last; s++) {
+        if (s == current) continue;
+        p.split = s;
+        const double cost = buildDag().cost;
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_split[id - F] = s;
+          improved = true;
+        }
+      }
+      p.split = best_split[id - F];
+    }
+  }
+
+  // Emit the best DAG with slots renumbered in execution order.
+  const Dag dag = buildDag();
+  MultiChainPlan plan;
+  plan.cost = dag.cost;
+  std::vector<unsigned> slot(F + P);
+  for (unsigned id = 0U; id < F; id++) {
+    slot[id] = id;
+    plan.rows.push_back(factors[id].rows);
+    plan.cols.push_back(factors[id].cols);
+  }
+  for (const auto& id : dag.node_of_step) {
+    const Product& p = products[id - F];
+    const auto [l, r] = children(p, p.split);
+    slot[id] = F + plan.steps.size();
+    plan.steps.push_back({slot[l], slot[r], slot[id]});
+    plan.rows.push_back(rowsOf(id));
+    plan.cols.push_back(colsOf(id));
+  }
+  for (unsigned c = 0U; c < seqs.size(); c++) {
+    plan.outputs.push_back(slot[node[c][at(c, 0U, seqs[c].size())]]);
+
+    Instance k;
+    for (const auto& id : seqs[c]) k.push_back(factors[id].rows);
+    k.push_back(factors[seqs[c].back()].cols);
+    if (k.size() > 2U) plan.independent_cost += exactCost(k);
+  }
+  return plan;
+}
+
+}  // namespace mc
@@ -0,0 +1,61 @@
+#ifndef MULTI_CHAIN_H
+#define MULTI_CHAIN_H
+
+#include <string>
+#include <vector>
+
+#include "planner.hpp"
+
+namespace mc {
+
+struct Factor {  // A named input matrix.
+  std::string name;
+  unsigned rows{0U}, cols{0U};
+
+  Factor() = default;
+
+  Factor(const std::string& name, const unsigned rows, const unsigned cols)
+      : name{name}, rows{rows}, cols{cols} {}
+};
+
+struct MultiChainPlan {
+  // Deduplicated execution DAG: slots 0..F-1 hold the factors and the s-th
+  // step writes slot F+s. Every step comes after the steps it reads from.
+  std::vector<Step> steps;
+  std::vector<unsigned> outputs;     // Slot holding the product of each chain.
+  std::vector<unsigned> rows, cols;  // Shape of every slot.
+  double cost{0.0};                  // FLOPs of the DAG.
+  double independent_cost{0.0};      // Sum of the chains' optimal costs.
+};
+
+/**
+ * @brief Jointly plans a set of chains over named factors, computing every
+ * product shared by several chains (the same contiguous run of factors) once.
+ *
+ * Every distinct run of factors is a node of a DP over shared intervals, so
+ * the same product is split in the same way wherever it appears. The cost of
+ * a product is amortised over its uses: the first round plans every chain on
+ * its own, the second divides the cost of every product by the number of
+ * times it appears across the chains, and later rounds by the number of uses
+ * in the DAG of the previous round. The cheapest DAG, costed with every
+ * product counted once, is then refined by re-splitting one materialised
+ * product at a time while the DAG gets cheaper. It is never more expensive
+ * than planning the chains independently. A chain with one factor outputs
+ * the factor's slot.
+ *
+ * Throws std::invalid_argument if a chain is empty, names an unknown factor
+ * or has mismatching inner dimensions.
+ *
+ * @param factors         input matrices.
+ * @param chains          sequences of factor names.
+ * @param n_rounds        number of amortisation rounds and of local search
+ *                        passes (at least 1).
+ * @return MultiChainPlan
+ */
+MultiChainPlan planChains(const std::vector<Factor>& factors,
+                          const std::vector<std::vector<std::string>>& chains,
+                          const unsigned n_rounds = 4U);
+
+}  // namespace mc
+
+#endif
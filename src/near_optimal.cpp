@@ -0,0 +1,132 @@
+#include "near_optimal.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "definitions.hpp"
+#include "exact.hpp"
+
+namespace mc {
+
+namespace {
+
+// Relative slack on the threshold, absorbing the rounding of the running sums.
+constexpr double bound_slack = 1e-12;
+
+struct Interval {
+  unsigned i, j;
+};
+
+struct Frame {  // An interval being split, and the split currently applied.
+  unsigned i, j, s;
+  bool applied;
+  unsigned n_pushed;  // Open intervals pushed by the applied split.
+};
+
+}  // namespace
+
+NearOptimalPlans nearOptimalPlans(const Instance& k, const double epsilon,
+                                  const std::size_t max_plans) {
+  if (epsilon < 0.0 or k.size() < 2U)
+    throw std::invalid_argument("nearOptimalPlans: invalid parameters");
+  const unsigned n = k.size() - 1U;
+  const unsigned stride = n + 1U;
+  std::vector<double> cost(stride * stride);
+  std::vector<unsigned> split(stride * stride), stack(2U * stride);
+
+  NearOptimalPlans plans;
+  plans.optimal_cost = exactSplits(k.data(), n, cost.data(), split.data());
+  if (n < 2U) {
+    plans.permutations.emplace_back();
+    plans.costs.push_back(0.0);
+    return plans;
+  }
+  const double threshold =
+      (1.0 + epsilon) * plans.optimal_cost * (1.0 + bound_slack);
+  auto C = [&](const unsigned i, const unsigned j) {
+    return cost[i * stride + j];
+  };
+
+  // State of the partial tree: fixed cost, open intervals and their bound.
+  double fixed = 0.0, open_bound = C(0U, n);
+  std::vector<Interval> open{{0U, n}};
+  std::vector<Frame> frames;
+  auto mult = [&](const Frame& f) {
+    return static_cast<double>(k[f.i]) * k[f.s] * k[f.j];
+  };
+
+  bool descending = true;
+  while (true) {
+    if (descending) {
+      descending = false;
+      if (open.empty()) {  // A complete tree: emit it.
+        Permutation perm(n - 1U);
+        splitsToOrder(n, split.data(), stack.data(), perm.data());
+        plans.permutations.push_back(std::move(perm));
+        plans.costs.push_back(fixed);
+        if (plans.permutations.size() >= max_plans) {
+          plans.complete = false;
+          break;
+        }
+      } else {
+        const Interval next = open.back();
+        open.pop_back();
+        open_bound -= C(next.i, next.j);
+        frames.push_back({next.i, next.j, next.i, false, 0U});
+      }
+    }
+    if (frames.empty()) break;
+
+    Frame& f = frames.back();
+    if (f.applied) {  // Undo the split tried last.
+      fixed -= mult(f);
+      for (unsigned p = 0U; p < f.n_pushed; p++) {
+        open_bound -= C(open.back().i, open.back().j);
+        open.pop_back();
+      }
+      f.applied = false;
+    }
+    for (f.s++; f.s < f.j; f.s++) {
+      if (fixed + mult(f) + open_bound + C(f.i, f.s) + C(f.s, f.j) >
+          threshold)
+        continue;
+      fixed += mult(f);
+      f.n_pushed = 0U;
+      for (const Interval child : {Interval{f.s, f.j}, Interval{f.i, f.s}}) {
+        if (child.j - child.i < 2U) continue;
+        open.push_back(child);
+        open_bound += C(child.i, child.j);
+        f.n_pushed++;
+      }
+      split[f.i * stride + f.j] = f.s;
+      f.applied = true;
+      descending = true;
+      break;
+    }
+    if (!f.applied) {  // Every split tried: give the interval back.
+      open.push_back({f.i, f.j});
+      open_bound += C(f.i, f.j);
+      frames.pop_back();
+    }
+  }
+
+  // Sort by increasing cost.
+  std::vector<std::size_t> idx(plans.costs.size());
+  std::iota(idx.begin(), idx.end(), 0U);
+  std::stable_sort(idx.begin(), idx.end(), [&](const auto a, const auto b) {
+    return plans.costs[a] < plans.costs[b];
+  });
+  NearOptimalPlans sorted;
+  sorted.optimal_cost = plans.optimal_cost;
+  sorted.complete = plans.complete;
+  for (const auto& a : idx) {
+    sorted.permutations.push_back(std::move(plans.permutations[a]));
+    sorted.costs.push_back(plans.costs[a]);
+  }
+  return sorted;
+}
+
+}  // namespace mc
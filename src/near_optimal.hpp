@@ -0,0 +1,45 @@
+#ifndef NEAR_OPTIMAL_H
+#define NEAR_OPTIMAL_H
+
+#include <cstddef>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+struct NearOptimalPlans {
+  std::vector<Permutation> permutations;  // Canonical, by increasing cost.
+  std::vector<double> costs;              // FLOPs of every permutation.
+  double optimal_cost{0.0};
+  bool complete{true};  // False if the enumeration stopped at max_plans.
+};
+
+/**
+ * @brief Enumerates every parenthesisation whose cost is within (1 + epsilon)
+ * of the optimum, without enumerating the others.
+ *
+ * Branch and bound growing trees top-down: a partial tree is a set of
+ * multiplications already fixed plus intervals still to be split, and its
+ * bound is the cost fixed so far plus the optimal cost of every open interval,
+ * from the table of the exact DP. That bound is attained by completing the
+ * tree optimally, so a branch is explored only if it leads to at least one
+ * parenthesisation within the threshold: after the O(n^3) DP, the work is
+ * O(n) per branch visited and grows with the number of plans returned, not
+ * with Catalan(n-1). The search is an iterative depth-first traversal, so it
+ * works for chains of any length.
+ *
+ * Throws std::invalid_argument if epsilon is negative or the instance has
+ * fewer than two dimensions.
+ *
+ * @param k           Instance.
+ * @param epsilon     relative tolerance over the optimal cost.
+ * @param max_plans   the enumeration stops after this many plans.
+ * @return NearOptimalPlans
+ */
+NearOptimalPlans nearOptimalPlans(const Instance& k, const double epsilon,
+                                  const std::size_t max_plans = 1U << 20);
+
+}  // namespace mc
+
+#endif
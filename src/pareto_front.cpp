@@ -0,0 +1,39 @@
+#include "pareto_front.hpp"
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+Permutation frontOrder(const std::vector<std::vector<FrontEntry>>& fronts,
+                       const unsigned n, const unsigned idx) {
+  auto at = [n](const unsigned i, const unsigned j) {
+    return i * (n + 1U) + j;
+  };
+  struct Frame {
+    unsigned i, j, idx;
+    bool expanded;
+  };
+
+  Permutation perm;
+  perm.reserve(n - 1U);
+  std::vector<Frame> stack{{0U, n, idx, false}};
+  while (!stack.empty()) {
+    const Frame f = stack.back();
+    stack.pop_back();
+    if (f.j - f.i < 2U) continue;
+    const FrontEntry& e = fronts[at(f.i, f.j)][f.idx];
+    if (f.expanded) {
+      perm.push_back(e.split);
+      continue;
+    }
+    const Frame l{f.i, e.split, e.left, false}, r{e.split, f.j, e.right, false};
+    stack.push_back({f.i, f.j, f.idx, true});
+    stack.push_back(e.left_first ? r : l);
+    stack.push_back(e.left_first ? l : r);
+  }
+  return perm;
+}
+
+}  // namespace mc
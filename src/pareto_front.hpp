@@ -0,0 +1,106 @@
+#ifndef PARETO_FRONT_H
+#define PARETO_FRONT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+struct FrontEntry {  // A non-dominated tree of an interval.
+  double flops, cost;           // FLOPs and the second objective.
+  unsigned split, left, right;  // Split and the entries of its operands.
+  bool left_first;              // Whether the left operand is computed first.
+};
+
+/**
+ * @brief Dynamic programming over intervals keeping, for every interval, the
+ * trees that are non-dominated in (FLOPs, cost), where the cost is a second
+ * objective that only grows with the costs of the operands (so dominated
+ * trees never lead to a front entry).
+ *
+ * combine(i, s, j, left, right) returns the cost of the product of the
+ * entries left (spanning i..s) and right (s..j), and whether the left operand
+ * is computed first, as a std::pair<double, bool>. keep(flops, cost) discards
+ * the candidates for which it returns false. Fronts longer than max_front are
+ * thinned to max_front evenly spaced entries, keeping both ends.
+ *
+ * Runs in O(n^3 F^2) for fronts of at most F entries.
+ *
+ * @param k         Instance.
+ * @param combine   callable (unsigned, unsigned, unsigned, const FrontEntry&,
+ * const FrontEntry&) -> std::pair<double, bool>.
+ * @param keep      callable (double, double) -> bool.
+ * @param max_front maximum number of entries per interval (at least 2).
+ * @return std::vector<std::vector<FrontEntry>> front of every interval i..j,
+ * at i * (n+1) + j, by increasing FLOPs (and so decreasing cost).
+ */
+template <typename Combine, typename Keep>
+std::vector<std::vector<FrontEntry>> paretoFronts(
+    const Instance& k, const Combine& combine, const Keep& keep,
+    const std::size_t max_front = std::numeric_limits<std::size_t>::max()) {
+  const unsigned n = k.size() - 1U;
+  auto at = [n](const unsigned i, const unsigned j) {
+    return i * (n + 1U) + j;
+  };
+
+  std::vector<std::vector<FrontEntry>> fronts((n + 1U) * (n + 1U));
+  for (unsigned i = 0U; i < n; i++)
+    fronts[at(i, i + 1U)].push_back({0.0, 0.0, 0U, 0U, 0U, true});
+  std::vector<FrontEntry> candidates;
+  for (unsigned len = 2U; len <= n; len++) {
+    for (unsigned i = 0U; i + len <= n; i++) {
+      const unsigned j = i + len;
+      candidates.clear();
+      for (unsigned s = i + 1U; s < j; s++) {
+        const auto& L = fronts[at(i, s)];
+        const auto& R = fronts[at(s, j)];
+        const double mult = static_cast<double>(k[i]) * k[s] * k[j];
+        for (unsigned a = 0U; a < L.size(); a++) {
+          for (unsigned b = 0U; b < R.size(); b++) {
+            const double flops = L[a].flops + R[b].flops + mult;
+            const std::pair<double, bool> c = combine(i, s, j, L[a], R[b]);
+            if (!keep(flops, c.first)) continue;
+            candidates.push_back({flops, c.first, s, a, b, c.second});
+          }
+        }
+      }
+      std::sort(candidates.begin(), candidates.end(),
+                [](const FrontEntry& x, const FrontEntry& y) {
+                  return x.flops < y.flops or
+                         (x.flops == y.flops and x.cost < y.cost);
+                });
+      auto& front = fronts[at(i, j)];
+      for (const auto& c : candidates)
+        if (front.empty() or c.cost < front.back().cost) front.push_back(c);
+      if (front.size() > max_front) {  // Thin out, keeping both ends.
+        std::vector<FrontEntry> thinned;
+        for (std::size_t t = 0U; t < max_front; t++)
+          thinned.push_back(front[t * (front.size() - 1U) / (max_front - 1U)]);
+        front = std::move(thinned);
+      }
+    }
+  }
+  return fronts;
+}
+
+/**
+ * @brief Returns the order of computation of the idx-th entry of the front of
+ * the whole chain, computing the operands of every product in the order
+ * recorded by left_first (a post-order of the tree).
+ *
+ * @param fronts        fronts as returned by paretoFronts.
+ * @param n             length of the chain.
+ * @param idx           entry of the front of the interval 0..n.
+ * @return Permutation
+ */
+Permutation frontOrder(const std::vector<std::vector<FrontEntry>>& fronts,
+                       const unsigned n, const unsigned idx);
+
+}  // namespace mc
+
+#endif
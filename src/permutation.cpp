@@ -7,67 +7,63 @@
 
 namespace mc {
 
-std::vector<PermutationTransformer::InfoEntry>
+thread_local std::vector<PermutationTransformer::InfoEntry>
     PermutationTransformer::table_info;
 
 Permutation PermutationTransformer::canonicalize(const Permutation& perm) {
-  clearTable();
-  table_info.resize(perm.size());
-  buildRepresentation(perm);
-  return buildPermutation(perm);
-}
+  if (perm.empty()) return perm;
 
-void PermutationTransformer::buildRepresentation(const Permutation& perm) {
-  for (const auto& p : perm) {
-    table_info[p - 1].computed = true;
-    addDependencies(p);
-  }
+  std::vector<InfoEntry>& table = table_info;
+  table.resize(perm.size() + 2U);
+  clearTable(table);
+  buildRepresentation(perm, table);
+  return buildPermutation(perm, table);
 }
 
-void PermutationTransformer::addDependencies(const unsigned& p) {
-  // add dependencies left
-  bool stop = false;
-  for (int i = p - 2; i >= 0 and !stop; --i) {
-    if (!table_info[i].computed) {
-      table_info[i].right = p;
-      stop = true;
-    }
-  }
+void PermutationTransformer::buildRepresentation(
+    const Permutation& perm, std::vector<InfoEntry>& table_info) {
+  // Multiplying at p joins the operands starting at prev[p] and at p, and
+  // the result starts at prev[p].
+  for (const auto& p : perm) {
+    const unsigned lo = table_info[p].prev;
+    table_info[p].left = table_info[lo].op;
+    table_info[p].right = table_info[p].op;
+    table_info[lo].op = p;
 
-  // add dependencies right
-  stop = false;
-  for (int i = p; i < static_cast<int>(table_info.size()) and !stop; ++i) {
-    if (!table_info[i].computed) {
-      table_info[i].left = p;
-      stop = true;
-    }
+    table_info[lo].next = table_info[p].next;
+    table_info[table_info[p].next].prev = lo;
   }
 }
 
-Permutation PermutationTransformer::buildPermutation(const Permutation& perm) {
+Permutation PermutationTransformer::buildPermutation(
+    const Permutation& perm, const std::vector<InfoEntry>& table_info) {
   Permutation canonical_perm{};
+  canonical_perm.reserve(perm.size());
 
-  buildRecursive(perm.back(), canonical_perm);
-  std::reverse(canonical_perm.begin(), canonical_perm.end());
-  return canonical_perm;
-}
-
-void PermutationTransformer::buildRecursive(const unsigned p,
-                                            Permutation& canonical_perm) {
-  canonical_perm.push_back(p);
+  // Root, right subtree, left subtree; reversed, this is the post-order
+  // left, right, root.
+  std::vector<unsigned> stack{perm.back()};
+  stack.reserve(perm.size());
+  while (!stack.empty()) {
+    const unsigned p = stack.back();
+    stack.pop_back();
+    canonical_perm.push_back(p);
 
-  if (table_info[p - 1].right != -1)
-    buildRecursive(table_info[p - 1].right, canonical_perm);
+    if (table_info[p].left != -1) stack.push_back(table_info[p].left);
+    if (table_info[p].right != -1) stack.push_back(table_info[p].right);
+  }
 
-  if (table_info[p - 1].left != -1)
-    buildRecursive(table_info[p - 1].left, canonical_perm);
+  std::reverse(canonical_perm.begin(), canonical_perm.end());
+  return canonical_perm;
 }
 
-void PermutationTransformer::clearTable() {
-  for (auto& entry : table_info) {
-    entry.computed = false;
-    entry.left = -1;
-    entry.right = -1;
+void PermutationTransformer::clearTable(std::vector<InfoEntry>& table_info) {
+  for (unsigned i = 0U; i < table_info.size(); i++) {
+    table_info[i].left = -1;
+    table_info[i].right = -1;
+    table_info[i].op = -1;
+    table_info[i].prev = i - 1U;
+    table_info[i].next = i + 1U;
   }
 }
 
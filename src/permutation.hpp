@@ -1,6 +1,7 @@
 #ifndef PERMUTATION_H
 #define PERMUTATION_H
 
+#include <stdexcept>
 #include <vector>
 
 #include "definitions.hpp"
@@ -8,33 +9,73 @@
 namespace mc {
 
 struct PermutationTransformer {
-  struct InfoEntry {
-    int left{-1}, right{-1};
-    bool computed{false};
+  struct InfoEntry {  // One per dimension of the chain.
+    int left{-1}, right{-1};  // Children of the multiplication at this
+                              // dimension (-1 for an input matrix).
+    int op{-1};  // Multiplication that produced the operand starting at this
+                 // dimension while it is alive (-1 for an input matrix).
+    unsigned prev{0U}, next{0U};  // Neighbouring dimensions still alive.
   };
 
-  static std::vector<InfoEntry> table_info;
+  // Per thread, so that canonicalize can be called concurrently.
+  static thread_local std::vector<InfoEntry> table_info;
 
   /**
    * @brief Returns the canonical form of the input permutation.
    *
+   * Runs in O(n) time and without recursion, so it works for chains of any
+   * length.
+   *
    * @param perm          Permutation of which to obtain the canonical form.
    * @return Permutation  Canonical form of the input permutation.
    */
   static Permutation canonicalize(const Permutation& perm);
 
  private:
-  static void clearTable();
-
-  static void buildRepresentation(const Permutation& perm);
+  // The helpers take the table by reference: thread_local lookups are costly
+  // in a shared library, so canonicalize resolves it only once.
+  static void clearTable(std::vector<InfoEntry>& table);
 
-  static void addDependencies(const unsigned& p);
+  static void buildRepresentation(const Permutation& perm,
+                                  std::vector<InfoEntry>& table);
 
-  static Permutation buildPermutation(const Permutation& perm);
-
-  static void buildRecursive(const unsigned p, Permutation& canonical_perm);
+  static Permutation buildPermutation(const Permutation& perm,
+                                      const std::vector<InfoEntry>& table);
 };
 
+/**
+ * @brief Decodes an order of computation of a chain of length n, calling
+ * visit(s, lo, p, hi) for its s-th multiplication, at dimension p, which
+ * multiplies the operands spanning dimensions lo..p and p..hi. Runs in O(n),
+ * with the dimensions still alive linked in prev/next.
+ *
+ * Throws std::invalid_argument if perm is not an order of computation of the
+ * chain (canonical or not).
+ *
+ * @param perm    order of computation.
+ * @param n       length of the chain.
+ * @param visit   callable (unsigned, unsigned, unsigned, unsigned).
+ */
+template <typename Visitor>
+void visitOrder(const Permutation& perm, const unsigned n, Visitor&& visit) {
+  if (perm.size() + 1U != n)
+    throw std::invalid_argument("Permutation does not match the chain");
+  std::vector<unsigned> prev(n + 1U), next(n + 1U);
+  for (unsigned i = 0U; i <= n; i++) {
+    prev[i] = i - 1U;
+    next[i] = i + 1U;
+  }
+  for (unsigned s = 0U; s < perm.size(); s++) {
+    const unsigned p = perm[s];
+    if (p == 0U or p >= n or next[prev[p]] != p)
+      throw std::invalid_argument("Invalid order of computation");
+    const unsigned lo = prev[p], hi = next[p];
+    visit(s, lo, p, hi);
+    next[lo] = hi;
+    prev[hi] = lo;
+  }
+}
+
 }  // namespace mc
 
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "plan_cache.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "definitions.hpp"
+
+namespace mc {
+
+std::size_t InstanceHash::operator()(const Instance& instance) const noexcept {
+  std::uint64_t h = 14695981039346656037ULL;  // FNV-1a.
+  for (const auto& k : instance) {
+    h ^= k;
+    h *= 1099511628211ULL;
+  }
+  return static_cast<std::size_t>(h ^ (h >> 29));
+}
+
+PlanCache::PlanCache(Solver solver, const std::size_t memory_budget,
+                     const unsigned n_shards, const bool normalize)
+    : solver{solver},
+      shard_budget{n_shards > 0U ? memory_budget / n_shards : 0U},
+      normalize{normalize} {
+  if (n_shards == 0U)
+    throw std::invalid_argument("PlanCache: at least one shard needed");
+  shards.reserve(n_shards);
+  for (unsigned i = 0U; i < n_shards; i++)
+    shards.push_back(std::make_unique<Shard>());
+}
+
+CachedPlan PlanCache::plan(const Instance& instance) {
+  unsigned scale;
+  Instance key = makeKey(instance, scale);
+  const double cube = static_cast<double>(scale) * scale * scale;
+  Shard& shard = getShard(key);
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+      n_hits.fetch_add(1U, std::memory_order_relaxed);
+      CachedPlan plan = it->second->plan;
+      plan.cost *= cube;
+      return plan;
+    }
+  }
+  n_misses.fetch_add(1U, std::memory_order_relaxed);
+
+  // Solve outside of the lock. The cost is stored for the key, which is the
+  // instance scaled by 1/scale, and FLOPs scale with the cube.
+  Entry entry{std::move(key), {}};
+  entry.plan.permutation = solver(entry.key);
+  entry.plan.cost = permutationFlops(entry.plan.permutation, entry.key);
+  CachedPlan plan = entry.plan;
+  plan.cost *= cube;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  insert(shard, std::move(entry));
+  return plan;
+}
+
+bool PlanCache::lookup(const Instance& instance, CachedPlan& plan) {
+  unsigned scale;
+  Instance key = makeKey(instance, scale);
+  Shard& shard = getShard(key);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    n_misses.fetch_add(1U, std::memory_order_relaxed);
+    return false;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  n_hits.fetch_add(1U, std::memory_order_relaxed);
+  plan = it->second->plan;
+  plan.cost *= static_cast<double>(scale) * scale * scale;
+  return true;
+}
+
+void PlanCache::clear() {
+  for (auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->index.clear();
+    shard->lru.clear();
+    shard->bytes = 0U;
+  }
+}
+
+std::size_t PlanCache::size() const {
+  std::size_t n_entries = 0U;
+  for (auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    n_entries += shard->index.size();
+  }
+  return n_entries;
+}
+
+std::size_t PlanCache::memoryUsage() const {
+  std::size_t bytes = 0U;
+  for (auto& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    bytes += shard->bytes;
+  }
+  return bytes;
+}
+
+Instance PlanCache::makeKey(const Instance& instance, unsigned& scale) const {
+  scale = 1U;
+  if (!normalize) return instance;
+
+  unsigned g = 0U;
+  for (const auto& k : instance) g = std::gcd(g, k);
+  if (g <= 1U) return instance;
+
+  scale = g;
+  Instance key(instance.size());
+  for (unsigned i = 0U; i < instance.size(); i++) key[i] = instance[i] / scale;
+  return key;
+}
+
+PlanCache::Shard& PlanCache::getShard(const Instance& key) {
+  // The low bits select the bucket inside the shard's map; use the high ones.
+  const std::size_t h = InstanceHash{}(key);
+  return *shards[(h >> 16) % shards.size()];
+}
+
+std::size_t PlanCache::entryBytes(const Entry& entry) {
+  // List node, map node and bucket, plus the heap storage of the vectors (the
+  // key is held by both the list and the map).
+  constexpr std::size_t overhead =
+      sizeof(Entry) + sizeof(Instance) + 6U * sizeof(void*);
+  return overhead + 2U * entry.key.capacity() * sizeof(unsigned) +
+         entry.plan.permutation.capacity() * sizeof(unsigned);
+}
+
+void PlanCache::insert(Shard& shard, Entry&& entry) {
+  auto it = shard.index.find(entry.key);
+  if (it != shard.index.end()) {  // Another thread got here first.
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return;
+  }
+
+  const std::size_t bytes = entryBytes(entry);
+  if (bytes > shard_budget) return;
+  while (shard.bytes + bytes > shard_budget) {
+    shard.bytes -= entryBytes(shard.lru.back());
+    shard.index.erase(shard.lru.back().key);
+    shard.lru.pop_back();
+  }
+
+  shard.lru.push_front(std::move(entry));
+  shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+  shard.bytes += bytes;
+}
+
+}  // namespace mc
@@ -0,0 +1,120 @@
+#ifndef PLAN_CACHE_H
+#define PLAN_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+struct CachedPlan {
+  Permutation permutation;  // Order of computation chosen by the solver.
+  double cost{0.0};         // Its cost (FLOPs) on the queried instance.
+};
+
+struct InstanceHash {
+  std::size_t operator()(const Instance& instance) const noexcept;
+};
+
+class PlanCache {  // Concurrent, memory-bounded cache of plans per shape.
+ public:
+  using Solver = std::function<Permutation(const Instance&)>;
+
+ private:
+  struct Entry {
+    Instance key;
+    CachedPlan plan;
+  };
+
+  struct Shard {  // An LRU list guarded by its own mutex.
+    std::mutex mutex;
+    std::list<Entry> lru;  // Most recently used first.
+    std::unordered_map<Instance, std::list<Entry>::iterator, InstanceHash>
+        index;
+    std::size_t bytes{0U};
+  };
+
+  Solver solver;
+  std::size_t shard_budget;  // Bytes per shard.
+  bool normalize;
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::atomic<std::uint64_t> n_hits{0U}, n_misses{0U};
+
+ public:
+  PlanCache() = delete;
+
+  /**
+   * @brief Parametrised constructor. Throws std::invalid_argument if
+   * n_shards is 0.
+   *
+   * @param solver        algorithm used on misses (e.g. mc::reduceMin).
+   * @param memory_budget approximate upper bound, in bytes, of the memory held
+   * by the cached entries.
+   * @param n_shards      number of independently locked shards.
+   * @param normalize     if true, instances are divided by the gcd of their
+   * dimensions before lookup, so uniformly scaled shapes share an entry.
+   */
+  PlanCache(Solver solver, const std::size_t memory_budget,
+            const unsigned n_shards = 16U, const bool normalize = false);
+
+  ~PlanCache() = default;
+
+  /**
+   * @brief Returns the plan for the instance, running the solver on a miss.
+   *
+   * @param instance    vector<unsigned>.
+   * @return CachedPlan permutation and its cost on the instance.
+   */
+  CachedPlan plan(const Instance& instance);
+
+  /**
+   * @brief Looks the instance up without running the solver.
+   *
+   * @param instance  vector<unsigned>.
+   * @param plan      set to the cached plan on a hit.
+   * @return true if the instance was cached.
+   */
+  bool lookup(const Instance& instance, CachedPlan& plan);
+
+  /**
+   * @brief Removes all entries. Counters are kept.
+   */
+  void clear();
+
+  // Getters for the counters and occupancy.
+  inline std::uint64_t hits() const noexcept { return n_hits.load(); }
+  inline std::uint64_t misses() const noexcept { return n_misses.load(); }
+  std::size_t size() const;
+  std::size_t memoryUsage() const;
+
+ private:
+  /**
+   * @brief Returns the key of the instance and the factor it was divided by.
+   */
+  Instance makeKey(const Instance& instance, unsigned& scale) const;
+
+  Shard& getShard(const Instance& key);
+
+  /**
+   * @brief Approximate number of bytes held by an entry.
+   */
+  static std::size_t entryBytes(const Entry& entry);
+
+  /**
+   * @brief Inserts the entry into the shard, evicting least recently used
+   * entries until it fits in the budget. Expects the shard to be locked.
+   */
+  void insert(Shard& shard, Entry&& entry);
+};
+
+}  // namespace mc
+
+#endif
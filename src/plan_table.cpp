@@ -0,0 +1,265 @@
+#include "plan_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "analyzer.hpp"
+#include "definitions.hpp"
+#include "generator.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+constexpr char magic[8] = {'M', 'C', 'T', 'A', 'B', '0', '1', '\0'};
+
+template <typename T>
+void writeValues(FILE* file, const T* values, const std::size_t count) {
+  std::fwrite(values, sizeof(T), count, file);
+}
+
+template <typename T>
+void readValues(FILE* file, T* values, const std::size_t count) {
+  if (std::fread(values, sizeof(T), count, file) != count)
+    throw std::runtime_error("PlanTable: truncated file");
+}
+
+// Throws unless count items of the given bytes each are left in the file of
+// the given size, so that a corrupt count never drives an allocation.
+void checkAvailable(FILE* file, const long size, const std::uint64_t count,
+                    const std::uint64_t bytes) {
+  const long at = std::ftell(file);
+  if (at < 0 or at > size or count > (size - at) / bytes)
+    throw std::runtime_error("PlanTable: truncated file");
+}
+
+}  // namespace
+
+PlanTable::PlanTable(const unsigned n, const std::vector<unsigned>& edges,
+                     const std::vector<Permutation>& perms,
+                     const std::vector<std::uint64_t>& run_starts,
+                     const std::vector<unsigned>& run_labels,
+                     const double penalty_bound)
+    : n{n},
+      edges{edges},
+      perms{perms},
+      run_starts{run_starts},
+      run_labels{run_labels},
+      penalty_bound{penalty_bound} {}
+
+PlanTable PlanTable::build(const unsigned n, const unsigned lo,
+                           const unsigned hi, const unsigned n_buckets) {
+  if (n < 2U or lo == 0U or lo >= hi or n_buckets == 0U)
+    throw std::invalid_argument("PlanTable: invalid parameters");
+
+  // Log-spaced boundaries, rounded to integers and deduplicated.
+  std::vector<unsigned> edges;
+  for (unsigned b = 0U; b <= n_buckets; b++) {
+    const double x =
+        lo * std::pow(static_cast<double>(hi) / lo,
+                      static_cast<double>(b) / n_buckets);
+    const unsigned edge = std::clamp<unsigned>(std::lround(x), lo, hi);
+    if (edges.empty() or edge > edges.back()) edges.push_back(edge);
+  }
+  const unsigned E = edges.size(), B = E - 1U, D = n + 1U;
+
+  std::vector<Algorithm> A = generateAlgorithms(n);
+  const unsigned M = A.size();
+  std::size_t n_points = 1U;
+  for (unsigned d = 0U; d < D; d++) {
+    n_points *= E;
+    if (n_points * M > max_table_entries)
+      throw std::length_error("PlanTable: grid too large");
+  }
+
+  // Every grid point as an instance, the last dimension running fastest.
+  std::vector<Instance> S(n_points, Instance(D));
+  for (std::size_t v = 0U; v < n_points; v++) {
+    std::size_t rest = v;
+    for (unsigned d = D; d-- > 0U;) {
+      S[v][d] = edges[rest % E];
+      rest /= E;
+    }
+  }
+  std::vector<double> ratio = FLOPsOnInstances(A, S);
+  const std::vector<double> min_A = getMinA(M, n_points, ratio);
+  for (std::size_t v = 0U; v < n_points; v++)
+    for (unsigned a = 0U; a < M; a++) ratio[v * M + a] /= min_A[v];
+  S.clear();
+
+  // Offsets, in grid points, of the corners of a cell from its lowest one.
+  std::vector<std::size_t> stride(D), corners(std::size_t{1} << D, 0U);
+  stride[D - 1U] = 1U;
+  for (unsigned d = D - 1U; d-- > 0U;) stride[d] = stride[d + 1U] * E;
+  for (std::size_t mask = 0U; mask < corners.size(); mask++)
+    for (unsigned d = 0U; d < D; d++)
+      if (mask & (std::size_t{1} << d)) corners[mask] += stride[d];
+
+  std::uint64_t n_cells = 1U;
+  for (unsigned d = 0U; d < D; d++) n_cells *= B;
+
+  std::vector<unsigned> label_of(M, std::numeric_limits<unsigned>::max());
+  std::vector<Permutation> perms;
+  std::vector<std::uint64_t> run_starts;
+  std::vector<unsigned> run_labels;
+  std::vector<double> worst(M);
+  std::vector<unsigned> bucket(D, 0U);
+  double bound = 0.0;
+  unsigned previous = M;
+  for (std::uint64_t cell = 0U; cell < n_cells; cell++) {
+    std::size_t base = 0U;
+    for (unsigned d = 0U; d < D; d++) base += bucket[d] * stride[d];
+
+    std::fill(worst.begin(), worst.end(), 0.0);
+    for (const auto& offset : corners) {
+      const double* r = ratio.data() + (base + offset) * M;
+      for (unsigned a = 0U; a < M; a++) worst[a] = std::max(worst[a], r[a]);
+    }
+    unsigned best = (previous < M) ? previous : 0U;
+    for (unsigned a = 0U; a < M; a++)
+      if (worst[a] < worst[best]) best = a;
+    bound = std::max(bound, worst[best] - 1.0);
+
+    if (best != previous) {
+      if (label_of[best] == std::numeric_limits<unsigned>::max()) {
+        label_of[best] = perms.size();
+        perms.push_back(A[best].getPermutation());
+      }
+      run_starts.push_back(cell);
+      run_labels.push_back(label_of[best]);
+      previous = best;
+    }
+
+    for (unsigned d = D; d-- > 0U;) {  // Next cell in row-major order.
+      if (++bucket[d] < B) break;
+      bucket[d] = 0U;
+    }
+  }
+  return PlanTable(n, edges, perms, run_starts, run_labels, bound);
+}
+
+PlanTable PlanTable::load(const std::string& path) {
+  FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr)
+    throw std::runtime_error("PlanTable: cannot open " + path);
+
+  bool valid = false;
+  std::uint32_t n = 0U, count = 0U;
+  double bound = 0.0;
+  std::vector<unsigned> edges, run_labels;
+  std::vector<Permutation> perms;
+  std::vector<std::uint64_t> run_starts;
+  std::uint64_t n_cells = 1U;
+  try {
+    std::fseek(file, 0L, SEEK_END);
+    const long size = std::ftell(file);
+    std::fseek(file, 0L, SEEK_SET);
+    char header[sizeof(magic)];
+    readValues(file, header, sizeof(header));
+    if (!std::equal(header, header + sizeof(header), magic))
+      throw std::runtime_error("PlanTable: bad header");
+
+    // Header fields, validated before they size anything.
+    readValues(file, &n, 1U);
+    readValues(file, &bound, 1U);
+    readValues(file, &count, 1U);
+    if (n < 2U or count < 2U)
+      throw std::runtime_error("PlanTable: bad header");
+    checkAvailable(file, size, count, sizeof(unsigned));
+    edges.resize(count);
+    readValues(file, edges.data(), count);
+    for (unsigned d = 0U; d <= n; d++) {
+      if (n_cells > std::numeric_limits<std::uint64_t>::max() / (count - 1U))
+        throw std::runtime_error("PlanTable: too many cells");
+      n_cells *= count - 1U;
+    }
+    readValues(file, &count, 1U);
+    checkAvailable(file, size, count,
+                   std::uint64_t{n - 1U} * sizeof(unsigned));
+    perms.assign(count, Permutation(n - 1U));
+    for (auto& perm : perms) readValues(file, perm.data(), perm.size());
+    std::uint64_t n_runs;
+    readValues(file, &n_runs, 1U);
+    checkAvailable(file, size, n_runs,
+                   sizeof(std::uint64_t) + sizeof(unsigned));
+    run_starts.resize(n_runs);
+    run_labels.resize(n_runs);
+    readValues(file, run_starts.data(), n_runs);
+    readValues(file, run_labels.data(), n_runs);
+
+    // Contents: ascending edges, runs covering the grid from its first cell
+    // and labelling valid orders of computation.
+    valid = edges[0] > 0U and !run_starts.empty() and run_starts[0] == 0U and
+            run_starts.back() < n_cells;
+    for (unsigned e = 1U; e < edges.size(); e++)
+      valid = valid and edges[e - 1U] < edges[e];
+    for (std::size_t r = 1U; r < run_starts.size(); r++)
+      valid = valid and run_starts[r - 1U] < run_starts[r];
+    for (const auto& label : run_labels) valid = valid and label < perms.size();
+    for (const auto& perm : perms)
+      visitOrder(perm, n, [](unsigned, unsigned, unsigned, unsigned) {});
+  } catch (const std::exception&) {
+    valid = false;
+  }
+  std::fclose(file);
+
+  if (!valid) throw std::runtime_error("PlanTable: invalid table: " + path);
+  return PlanTable(n, edges, perms, run_starts, run_labels, bound);
+}
+
+void PlanTable::save(const std::string& path) const {
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    throw std::runtime_error("PlanTable: cannot open " + path);
+
+  const std::uint32_t length = n, n_edges = edges.size(),
+                      n_perms = perms.size();
+  const std::uint64_t n_runs = run_starts.size();
+  writeValues(file, magic, sizeof(magic));
+  writeValues(file, &length, 1U);
+  writeValues(file, &penalty_bound, 1U);
+  writeValues(file, &n_edges, 1U);
+  writeValues(file, edges.data(), edges.size());
+  writeValues(file, &n_perms, 1U);
+  for (const auto& perm : perms) writeValues(file, perm.data(), perm.size());
+  writeValues(file, &n_runs, 1U);
+  writeValues(file, run_starts.data(), run_starts.size());
+  writeValues(file, run_labels.data(), run_labels.size());
+  const bool failed = std::ferror(file) != 0;
+  if (std::fclose(file) != 0 or failed)
+    throw std::runtime_error("PlanTable: cannot write " + path);
+}
+
+const Permutation& PlanTable::lookup(const Instance& instance) const {
+  const unsigned B = edges.size() - 1U;
+  std::uint64_t cell = 0U;
+  for (unsigned d = 0U; d <= n; d++) {
+    const auto it = std::upper_bound(edges.begin(), edges.end(), instance[d]);
+    const unsigned b = std::clamp<long>(it - edges.begin() - 1, 0L, B - 1L);
+    cell = cell * B + b;
+  }
+  const auto run =
+      std::upper_bound(run_starts.begin(), run_starts.end(), cell) - 1;
+  return perms[run_labels[run - run_starts.begin()]];
+}
+
+std::size_t PlanTable::memoryUsage() const {
+  return sizeof(*this) + edges.size() * sizeof(unsigned) +
+         perms.size() * (sizeof(Permutation) + (n - 1U) * sizeof(unsigned)) +
+         run_starts.size() * (sizeof(std::uint64_t) + sizeof(unsigned));
+}
+
+std::uint64_t PlanTable::getNumCells() const {
+  std::uint64_t n_cells = 1U;
+  for (unsigned d = 0U; d <= n; d++) n_cells *= edges.size() - 1U;
+  return n_cells;
+}
+
+}  // namespace mc
@@ -0,0 +1,122 @@
+#ifndef PLAN_TABLE_H
+#define PLAN_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Binary layout (native endianness): the 8 bytes "MCTAB01\0", uint32 n,
+// double penalty bound, uint32 number of edges followed by the edges as
+// uint32, uint32 number of permutations followed by each as n - 1 uint32,
+// uint64 number of runs followed by the starts as uint64 and the labels as
+// uint32.
+
+class PlanTable {  // Precomputed plans over a log-spaced grid of dimensions.
+ private:
+  unsigned n;                       // Length of the chain.
+  std::vector<unsigned> edges;      // Bucket boundaries, shared by all dims.
+  std::vector<Permutation> perms;   // Plans referenced by the runs.
+  std::vector<std::uint64_t> run_starts;  // First cell of every run.
+  std::vector<unsigned> run_labels;       // Index into perms per run.
+  double penalty_bound;
+
+ public:
+  PlanTable() = delete;
+
+  /**
+   * @brief Parametrised constructor from already built data.
+   *
+   * @param n             length of the chain.
+   * @param edges         ascending bucket boundaries (at least two).
+   * @param perms         plans referenced by the runs.
+   * @param run_starts    first cell of every run, ascending from 0.
+   * @param run_labels    index into perms of every run.
+   * @param penalty_bound largest penalty of a plan within its cell.
+   */
+  PlanTable(const unsigned n, const std::vector<unsigned>& edges,
+            const std::vector<Permutation>& perms,
+            const std::vector<std::uint64_t>& run_starts,
+            const std::vector<unsigned>& run_labels,
+            const double penalty_bound);
+
+  /**
+   * @brief Builds the table for chains of length n whose dimensions lie in
+   * [lo, hi].
+   *
+   * Every dimension is split into n_buckets log-spaced buckets (fewer if
+   * rounding the boundaries to integers merges some), and every cell of the
+   * resulting grid is labelled with the parenthesisation of least worst
+   * penalty across the cell's corners, among all of them (generateAlgorithms
+   * and FLOPsOnInstances on the grid points). The ratio of the costs of two
+   * parenthesisations is monotone in every dimension, so the worst penalty
+   * over a cell is attained at a corner and the reported bound holds for any
+   * instance inside [lo, hi]. Cells are stored as runs of equal labels in
+   * row-major order, ties being broken towards the previous cell's label.
+   *
+   * Throws std::invalid_argument if n < 2, lo == 0, lo >= hi or
+   * n_buckets == 0, and std::length_error if the grid has more than
+   * max_table_entries (grid points x parenthesisations).
+   *
+   * @param n         length of the chain.
+   * @param lo        smallest dimension covered.
+   * @param hi        largest dimension covered.
+   * @param n_buckets number of buckets per dimension.
+   * @return PlanTable
+   */
+  static PlanTable build(const unsigned n, const unsigned lo,
+                         const unsigned hi, const unsigned n_buckets);
+
+  /**
+   * @brief Reads a table written by save. Throws std::runtime_error if the
+   * file cannot be opened or is not a valid table: every count is checked
+   * against the bytes left in the file before allocating, the edges must
+   * ascend, the runs must start at cell 0 and ascend strictly below
+   * getNumCells(), and every plan must be an order of computation.
+   */
+  static PlanTable load(const std::string& path);
+
+  /**
+   * @brief Writes the table. Throws std::runtime_error if the file cannot be
+   * written.
+   */
+  void save(const std::string& path) const;
+
+  /**
+   * @brief Returns the plan for the instance in O(n log(edges) + log(runs)).
+   * Dimensions outside of the covered range are clamped to it, in which case
+   * the penalty bound does not apply.
+   *
+   * @param instance      vector<unsigned> of length n + 1.
+   * @return Permutation  plan of the instance's cell.
+   */
+  const Permutation& lookup(const Instance& instance) const;
+
+  /**
+   * @brief Approximate number of bytes held by the table.
+   */
+  std::size_t memoryUsage() const;
+
+  // Upper limit on grid points x parenthesisations evaluated by build.
+  static constexpr std::size_t max_table_entries = std::size_t{1} << 27;
+
+  // Getters for the table's data.
+  inline unsigned getLength() const noexcept { return n; }
+  inline double getPenaltyBound() const noexcept { return penalty_bound; }
+  inline const std::vector<unsigned>& getEdges() const noexcept {
+    return edges;
+  }
+  inline const std::vector<Permutation>& getPerms() const noexcept {
+    return perms;
+  }
+  inline std::size_t getNumRuns() const noexcept { return run_starts.size(); }
+  std::uint64_t getNumCells() const;
+};
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,152 @@
+#include "planner.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "exact.hpp"
+
+namespace mc {
+
+Planner::Planner(const unsigned max_n, const unsigned exact_threshold)
+    : max_n{max_n}, exact_threshold{std::min(exact_threshold, max_n)} {
+  const unsigned exact_dims = this->exact_threshold + 1U;
+  cost.resize(exact_dims * exact_dims);
+  split.resize(exact_dims * exact_dims);
+  stack.resize(2U * exact_dims);
+
+  r.resize(max_n + 1U);
+  order.resize(max_n);
+  chin_order.resize(max_n);
+  queue.resize(max_n + 1U);
+  prev.resize(max_n + 1U);
+  next.resize(max_n + 1U);
+  slot.resize(max_n + 1U);
+}
+
+double Planner::plan(const unsigned* dims, const std::size_t n_dims,
+                     Step* schedule) {
+  if (n_dims < 2U)
+    throw std::invalid_argument("Planner: a chain needs at least 2 dims");
+  const unsigned n = n_dims - 1U;
+  if (n > max_n) throw std::length_error("Planner: chain longer than max_n");
+
+  if (n <= exact_threshold)
+    planExact(dims, n);
+  else
+    planReduceMin(dims, n);
+
+  return buildSchedule(dims, n, schedule);
+}
+
+void Planner::planExact(const unsigned* dims, const unsigned n) {
+  exactSplits(dims, n, cost.data(), split.data());
+  splitsToOrder(n, split.data(), stack.data(), order.data());
+}
+
+void Planner::planReduceMin(const unsigned* dims, const unsigned n) {
+  // Same steps as reduceMin (see apprx_algorithms.cpp), with the deque
+  // replaced by the window queue[front..back] over preallocated storage.
+  unsigned m = 0U;
+  for (unsigned i = 1U; i <= n; i++) {
+    if (dims[i] < dims[m]) m = i;
+  }
+  for (unsigned i = 0U; i <= n; i++) r[i] = 1.0 / static_cast<double>(dims[i]);
+  std::fill(chin_order.begin(), chin_order.begin() + n - 1U, 0U);
+  unsigned* v = chin_order.data();  // Chin's order of computation.
+  unsigned* Q = queue.data();
+
+  // Scan forward.
+  unsigned front = 0U, back = 0U;  // Q holds queue[front..back).
+  Q[back++] = 0U;
+  unsigned a = 1U;
+  for (unsigned i = 1U; i < n; i++) {
+    Q[back++] = i;
+    while (back - front >= 2U and
+           (r[Q[back - 1U]] + r[m] < r[Q[back - 2U]] + r[i + 1U])) {
+      v[Q[back - 1U] - 1U] = a;
+      a++;
+      back--;
+    }
+  }
+  Q[back++] = n;
+
+  // Nibble at both ends.
+  unsigned b = n - 1U;
+  while (back - front >= 3U) {
+    if (r[Q[back - 1U]] + r[m] < r[Q[back - 2U]] + r[Q[front]]) {
+      back--;
+      v[Q[back - 1U] - 1U] = b;
+      b--;
+    } else if (r[Q[front]] + r[m] < r[Q[front + 1U]] + r[Q[back - 1U]]) {
+      front++;
+      v[Q[front] - 1U] = b;
+      b--;
+    } else {
+      break;
+    }
+  }
+
+  // Minimise over the essential parenthesisations of the remaining chain.
+  if (back - front >= 3U) {
+    const unsigned q_n = back - front - 1U;
+    auto q = [&](const unsigned i) -> double { return dims[Q[front + i]]; };
+
+    double x = q(0U) * q(q_n);
+    for (unsigned i = 1U; i <= q_n; i++) x += q(i - 1U) * q(i);
+
+    unsigned h_q = 0U;
+    double t_h = q(0U) * (x - q(0U) * q(q_n) - q(0U) * q(1U));
+    for (unsigned i = 1U; i <= q_n; i++) {
+      const unsigned i_r = (i == q_n) ? 0U : i + 1U;
+      const double t = q(i) * (x - q(i - 1U) * q(i) - q(i) * q(i_r));
+      if (t < t_h) {
+        t_h = t;
+        h_q = i;
+      }
+    }
+    const unsigned h = Q[front + h_q];
+
+    // Apply the selected essential parenthesisation.
+    for (unsigned i = h - 1U; h > Q[front] and i > Q[front]; i--) {
+      if (v[i - 1U] == 0U) v[i - 1U] = a++;
+    }
+    for (unsigned i = h + 1U; i < Q[back - 1U]; i++) {
+      if (v[i - 1U] == 0U) v[i - 1U] = a++;
+    }
+
+    // Final multiplication, if any.
+    if (h != 0U and h != n and v[h - 1U] == 0U) v[h - 1U] = a;
+  }
+
+  // From Chin's format (position of every dimension) to an order.
+  for (unsigned i = 0U; i + 1U < n; i++) order[v[i] - 1U] = i + 1U;
+}
+
+double Planner::buildSchedule(const unsigned* dims, const unsigned n,
+                              Step* schedule) {
+  // prev/next link the dimensions that are still alive; the operand spanning
+  // dimensions [lo, hi] lives in slot[lo].
+  for (unsigned i = 0U; i <= n; i++) {
+    prev[i] = i - 1U;
+    next[i] = i + 1U;
+    slot[i] = i;
+  }
+
+  double flops = 0.0;
+  for (unsigned s = 0U; s + 1U < n; s++) {
+    const unsigned p = order[s];
+    const unsigned lo = prev[p], hi = next[p];
+    schedule[s] = {slot[lo], slot[p], n + s};
+    flops += static_cast<double>(dims[lo]) * static_cast<double>(dims[p]) *
+             static_cast<double>(dims[hi]);
+
+    slot[lo] = n + s;
+    next[lo] = hi;
+    prev[hi] = lo;
+  }
+  return flops;
+}
+
+}  // namespace mc
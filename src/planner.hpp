@@ -0,0 +1,82 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace mc {
+
+// One multiplication of an execution schedule. Operand slots 0..n-1 hold the
+// input matrices; the s-th multiplication of the schedule writes slot n+s.
+struct Step {
+  unsigned left, right, result;
+};
+
+class Planner {  // Allocation-free planner for embedding in a runtime.
+ public:
+  // Up to this length, the exact DP plans in under a microsecond; longer
+  // chains (checked up to n = 32) take reduceMin, also under a microsecond.
+  static constexpr unsigned default_exact_threshold = 8U;
+
+ private:
+  unsigned max_n;
+  unsigned exact_threshold;
+
+  // Workspace, allocated once at construction.
+  std::vector<double> cost, r;
+  std::vector<unsigned> split, stack, order, chin_order, queue;
+  std::vector<unsigned> prev, next, slot;
+
+ public:
+  Planner() = delete;
+
+  /**
+   * @brief Parametrised constructor. Allocates all the workspace needed to plan
+   * chains of up to max_n matrices.
+   *
+   * @param max_n           maximum length of the chains to plan.
+   * @param exact_threshold chains of length <= exact_threshold are planned
+   * with the exact DP, longer ones with reduceMin.
+   */
+  Planner(const unsigned max_n,
+          const unsigned exact_threshold = default_exact_threshold);
+
+  ~Planner() = default;
+
+  /**
+   * @brief Plans the chain with the passed dimensions. Does not allocate.
+   *
+   * Throws std::length_error if the chain is longer than max_n, and
+   * std::invalid_argument if fewer than two dimensions are passed.
+   *
+   * @param dims      pointer to the dimensions of the chain (n+1 values).
+   * @param n_dims    number of dimensions (n+1).
+   * @param schedule  caller-provided storage for n-1 steps, in execution order.
+   * @return double   cost (FLOPs) of the planned schedule.
+   */
+  double plan(const unsigned* dims, const std::size_t n_dims, Step* schedule);
+
+  // Getters for the configuration.
+  inline unsigned getMaxLength() const noexcept { return max_n; }
+  inline unsigned getExactThreshold() const noexcept { return exact_threshold; }
+
+ private:
+  /**
+   * @brief Fills order with the canonical order of an optimal parenthesisation.
+   */
+  void planExact(const unsigned* dims, const unsigned n);
+
+  /**
+   * @brief Fills order with the order of computation yielded by reduceMin.
+   */
+  void planReduceMin(const unsigned* dims, const unsigned n);
+
+  /**
+   * @brief Translates order into operand slots and returns its cost.
+   */
+  double buildSchedule(const unsigned* dims, const unsigned n, Step* schedule);
+};
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef PROPERTY_CHAIN_H
+#define PROPERTY_CHAIN_H
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "apprx_algorithms.hpp"
+#include "definitions.hpp"
+#include "exact.hpp"
+#include "generator.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+// Planning for chains whose factors carry properties that change the cost of
+// their multiplications (structure, density, ...). A model describes them:
+//
+//   struct Model {
+//     using Property = ...;
+//     const Instance& dims;                   // n+1 dimensions.
+//     Property leaf(const unsigned i) const;  // Factor i (dims i..i+1).
+//     Property general() const;               // A dense general operand.
+//     Property product(const Property& left, const unsigned k,
+//                      const Property& right) const;
+//     double multCost(const unsigned m, const unsigned k, const unsigned n,
+//                     const Property& left, const Property& right) const;
+//   };
+//
+// product returns the property of the product of two operands with inner
+// dimension k, and multCost the cost of that multiplication for a (m x k) by
+// a (k x n) operand. The property of a product must not depend on its
+// parenthesisation, so that every interval of the chain has one.
+
+/**
+ * @brief Returns the property of every interval i..j of the chain, at
+ * i * (n+1) + j (for j > i), in O(n^2).
+ */
+template <typename Model>
+std::vector<typename Model::Property> intervalProperties(const Model& model) {
+  const unsigned n = model.dims.size() - 1U;
+  const unsigned stride = n + 1U;
+  std::vector<typename Model::Property> property(stride * stride);
+  for (unsigned i = 0U; i < n; i++) {
+    property[i * stride + i + 1U] = model.leaf(i);
+    for (unsigned j = i + 2U; j <= n; j++)
+      property[i * stride + j] =
+          model.product(property[i * stride + j - 1U], model.dims[j - 1U],
+                        model.leaf(j - 1U));
+  }
+  return property;
+}
+
+/**
+ * @brief Returns an optimal order of computation under the cost of the model
+ * (O(n^3) dynamic programming).
+ *
+ * @param model         Model of the chain.
+ * @return Permutation  Canonical order of an optimal parenthesisation.
+ */
+template <typename Model>
+Permutation propertyExact(const Model& model) {
+  const unsigned n = model.dims.size() - 1U;
+  const unsigned stride = n + 1U;
+  const Instance& k = model.dims;
+  const auto property = intervalProperties(model);
+
+  std::vector<double> cost(stride * stride);
+  std::vector<unsigned> split(stride * stride), stack(2U * stride);
+  intervalSplits(
+      n,
+      [&](const unsigned i, const unsigned s, const unsigned j) {
+        return model.multCost(k[i], k[s], k[j], property[i * stride + s],
+                              property[s * stride + j]);
+      },
+      cost.data(), split.data());
+  Permutation perm(n - 1U);
+  splitsToOrder(n, split.data(), stack.data(), perm.data());
+  return perm;
+}
+
+/**
+ * @brief Returns the cost of an order of computation under the model. Runs
+ * in O(n).
+ *
+ * Throws std::invalid_argument if perm is not an order of computation of the
+ * chain.
+ *
+ * @param model   Model of the chain.
+ * @param perm    order of computation.
+ * @return double cost.
+ */
+template <typename Model>
+double propertyCost(const Model& model, const Permutation& perm) {
+  const Instance& k = model.dims;
+  const unsigned n = k.size() - 1U;
+  std::vector<typename Model::Property> operand;  // Starting at dimension i.
+  operand.reserve(n);
+  for (unsigned i = 0U; i < n; i++) operand.push_back(model.leaf(i));
+
+  double cost = 0.0;
+  visitOrder(perm, n,
+             [&](const unsigned, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+               cost += model.multCost(k[lo], k[p], k[hi], operand[lo],
+                                      operand[p]);
+               operand[lo] = model.product(operand[lo], k[p], operand[p]);
+             });
+  return cost;
+}
+
+/**
+ * @brief Whether vertex b of the polygon is cut off first, i.e. whether
+ * multiplying the adjacent operands (a x b, left) and (b x c, right) together
+ * before joining them to the rest of the chain (costed as a general operand
+ * with dimension m) is cheaper than joining each to it. With dense costs,
+ * this is the test of Lemma 1 in (Chin 1978).
+ */
+template <typename Model>
+bool cutFirst(const Model& model, const typename Model::Property& left,
+              const unsigned a, const unsigned b, const unsigned c,
+              const typename Model::Property& right, const unsigned m) {
+  const auto general = model.general();
+  const double together =
+      model.multCost(a, b, c, left, right) +
+      model.multCost(a, c, m, model.product(left, b, right), general);
+  const double apart =
+      model.multCost(b, c, m, right, general) +
+      model.multCost(a, b, m, left, model.product(right, c, general));
+  return together < apart;
+}
+
+template <typename Property>
+struct PropertyReduction {  // See ChainReduction (reduction.hpp).
+  std::vector<unsigned> index;     // Dimensions of the reduced chain.
+  std::vector<Property> operands;  // Between index[t] and index[t+1].
+  Permutation first;  // Forced multiplications done before the others.
+  Permutation last;   // Forced multiplications done after the others.
+};
+
+/**
+ * @brief The reduction of reduceChain under the cost of the model: the
+ * forward scan and the nibbling at both ends apply cutFirst instead of
+ * Lemma 1 in (Chin 1978), which it matches for dense costs. With other
+ * costs, the multiplications it fixes are a greedy choice, no longer proven
+ * to be in an optimal order. Runs in O(n).
+ *
+ * @param model                       Model of the chain.
+ * @return PropertyReduction<Property>
+ */
+template <typename Model>
+PropertyReduction<typename Model::Property> propertyReduction(
+    const Model& model) {
+  using Property = typename Model::Property;
+  const Instance& k = model.dims;
+  const unsigned n = k.size() - 1U;
+  const unsigned k_m = *std::min_element(k.begin(), k.end());
+
+  // Scan forward; pending is the operand from Q.back() to dimension i.
+  PropertyReduction<Property> reduction;
+  std::deque<unsigned> Q{0U};
+  std::deque<Property> ops;
+  Property pending = model.leaf(0U);
+  for (unsigned i = 1U; i < n; i++) {
+    Q.push_back(i);
+    ops.push_back(pending);
+    pending = model.leaf(i);
+    while (Q.size() >= 2U and cutFirst(model, ops.back(), k[Q[Q.size() - 2U]],
+                                       k[Q.back()], k[i + 1U], pending, k_m)) {
+      reduction.first.push_back(Q.back());
+      pending = model.product(ops.back(), k[Q.back()], pending);
+      ops.pop_back();
+      Q.pop_back();
+    }
+  }
+  Q.push_back(n);
+  ops.push_back(pending);
+
+  // Nibble at both ends; the side joining them is the result of the chain.
+  const Property general = model.general();
+  while (Q.size() >= 3U) {
+    if (cutFirst(model, ops.back(), k[Q[Q.size() - 2U]], k[Q.back()],
+                 k[Q.front()], general, k_m)) {
+      Q.pop_back();
+      ops.pop_back();
+      reduction.last.push_back(Q.back());
+    } else if (cutFirst(model, general, k[Q.back()], k[Q.front()], k[Q[1]],
+                        ops.front(), k_m)) {
+      Q.pop_front();
+      ops.pop_front();
+      reduction.last.push_back(Q.front());
+    } else {
+      break;
+    }
+  }
+  std::reverse(reduction.last.begin(), reduction.last.end());
+  reduction.index.assign(Q.begin(), Q.end());
+  reduction.operands.assign(ops.begin(), ops.end());
+  return reduction;
+}
+
+/**
+ * @brief Returns the cost under the model of the fan out from dimension w of
+ * a reduced chain (the essential parenthesisation of getEssentialPerm). Runs
+ * in O(n).
+ */
+template <typename Model>
+double fanCost(const Model& model,
+               const PropertyReduction<typename Model::Property>& chain,
+               const unsigned w) {
+  const unsigned L = chain.index.size();
+  auto dim = [&](const unsigned t) { return model.dims[chain.index[t]]; };
+  double cost = 0.0;
+
+  // Left of w, from w outwards, and right of w likewise.
+  auto left = (w > 0U) ? chain.operands[w - 1U] : model.general();
+  for (unsigned t = w; t-- > 1U;) {
+    cost += model.multCost(dim(t - 1U), dim(t), dim(w),
+                           chain.operands[t - 1U], left);
+    left = model.product(chain.operands[t - 1U], dim(t), left);
+  }
+  auto right = (w + 1U < L) ? chain.operands[w] : model.general();
+  for (unsigned t = w + 1U; t + 1U < L; t++) {
+    cost += model.multCost(dim(w), dim(t), dim(t + 1U), right,
+                           chain.operands[t]);
+    right = model.product(right, dim(t), chain.operands[t]);
+  }
+  if (w > 0U and w + 1U < L)
+    cost += model.multCost(dim(0U), dim(w), dim(L - 1U), left, right);
+  return cost;
+}
+
+/**
+ * @brief Returns the fan out with the least cost under the model of a reduced
+ * chain, with the forced multiplications around it, as a canonical order.
+ *
+ * Rather than the L fans (O(L^2) under a general cost), only a few are
+ * costed: those from the three smallest dimensions and from the one whose
+ * fan is cheapest with dense costs (found by essentialCosts). Runs in O(n).
+ */
+template <typename Model>
+Permutation bestFan(const Model& model,
+                    const PropertyReduction<typename Model::Property>& chain) {
+  const unsigned L = chain.index.size();
+  Permutation order(chain.first);
+  if (L >= 3U) {
+    Instance q(L);
+    for (unsigned t = 0U; t < L; t++) q[t] = model.dims[chain.index[t]];
+    std::vector<unsigned> candidates{minEssential(q)};
+    std::vector<unsigned> by_size(L);
+    for (unsigned t = 0U; t < L; t++) by_size[t] = t;
+    const unsigned n_smallest = std::min(3U, L);
+    std::partial_sort(
+        by_size.begin(), by_size.begin() + n_smallest, by_size.end(),
+        [&q](const unsigned a, const unsigned b) { return q[a] < q[b]; });
+    candidates.insert(candidates.end(), by_size.begin(),
+                      by_size.begin() + n_smallest);
+
+    unsigned w = candidates.front();
+    double best = fanCost(model, chain, w);
+    for (const auto& c : candidates) {
+      const double cost = fanCost(model, chain, c);
+      if (cost < best) {
+        best = cost;
+        w = c;
+      }
+    }
+    for (const auto& t : getEssentialPerm(L - 1U, w))
+      order.push_back(chain.index[t]);
+  }
+  order.insert(order.end(), chain.last.begin(), chain.last.end());
+  return PermutationTransformer::canonicalize(order);
+}
+
+/**
+ * @brief Returns the cheapest fan out under the model among those costed by
+ * bestFan, on the whole chain. Runs in O(n).
+ *
+ * @param model         Model of the chain.
+ * @return Permutation  Canonical order of computation.
+ */
+template <typename Model>
+Permutation propertyMinEssential(const Model& model) {
+  PropertyReduction<typename Model::Property> chain;
+  const unsigned n = model.dims.size() - 1U;
+  for (unsigned i = 0U; i <= n; i++) chain.index.push_back(i);
+  for (unsigned i = 0U; i < n; i++) chain.operands.push_back(model.leaf(i));
+  return bestFan(model, chain);
+}
+
+/**
+ * @brief Algorithm 3 under the cost of the model: propertyReduction, then
+ * bestFan on the reduced chain. As the reduction is only greedy with costs
+ * other than dense ones, the result is compared with propertyMinEssential
+ * and the cheaper is returned. Runs in O(n).
+ *
+ * @param model         Model of the chain.
+ * @return Permutation  Canonical order of computation.
+ */
+template <typename Model>
+Permutation propertyReduceMin(const Model& model) {
+  Permutation reduced = bestFan(model, propertyReduction(model));
+  Permutation fan = propertyMinEssential(model);
+  return (propertyCost(model, fan) < propertyCost(model, reduced)) ? fan
+                                                                   : reduced;
+}
+
+}  // namespace mc
+
+#endif
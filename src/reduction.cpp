@@ -0,0 +1,86 @@
+#include "reduction.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.hpp"
+#include "exact.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+ChainReduction reduceChain(const Instance& k) {
+  if (k.size() < 2U)
+    throw std::invalid_argument("reduceChain: chain too short");
+  const unsigned n = k.size() - 1U;
+  const unsigned m = static_cast<unsigned>(
+      std::distance(k.begin(), std::min_element(k.begin(), k.end())));
+
+  std::vector<double> r(k.size());
+  for (unsigned i = 0U; i <= n; i++) r[i] = 1.0 / static_cast<double>(k[i]);
+
+  ChainReduction reduction;
+  auto fix = [&](Permutation& order, const unsigned lo, const unsigned p,
+                 const unsigned hi) {
+    order.push_back(p);
+    reduction.forced_flops += static_cast<double>(k[lo]) * k[p] * k[hi];
+  };
+
+  // Scan forward.
+  std::deque<unsigned> Q{0U};
+  for (unsigned i = 1U; i < n; i++) {
+    Q.push_back(i);
+    while (Q.size() >= 2U and
+           (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[i + 1U])) {
+      fix(reduction.first, Q[Q.size() - 2U], Q.back(), i + 1U);
+      Q.pop_back();
+    }
+  }
+  Q.push_back(n);
+
+  // Nibble at both ends, from the last multiplication backwards.
+  while (Q.size() >= 3U) {
+    if (r[Q.back()] + r[m] < r[Q[Q.size() - 2U]] + r[Q.front()]) {
+      const unsigned hi = Q.back();
+      Q.pop_back();
+      fix(reduction.last, Q.front(), Q.back(), hi);
+    } else if (r[Q.front()] + r[m] < r[Q[1]] + r[Q.back()]) {
+      const unsigned lo = Q.front();
+      Q.pop_front();
+      fix(reduction.last, lo, Q.front(), Q.back());
+    } else {
+      break;
+    }
+  }
+  std::reverse(reduction.last.begin(), reduction.last.end());
+
+  reduction.index.assign(Q.begin(), Q.end());
+  for (const auto& i : reduction.index) reduction.reduced.push_back(k[i]);
+  return reduction;
+}
+
+Permutation expandReduction(const ChainReduction& reduction,
+                            const Permutation& reduced_perm) {
+  if (reduced_perm.size() + 2U != reduction.reduced.size())
+    throw std::invalid_argument("Permutation does not match the reduction");
+  Permutation order(reduction.first);
+  order.reserve(reduction.first.size() + reduced_perm.size() +
+                reduction.last.size());
+  for (const auto& p : reduced_perm) {
+    if (p == 0U or p + 1U >= reduction.index.size())
+      throw std::invalid_argument("Invalid order of computation");
+    order.push_back(reduction.index[p]);
+  }
+  order.insert(order.end(), reduction.last.begin(), reduction.last.end());
+  return PermutationTransformer::canonicalize(order);
+}
+
+Permutation reducedExact(const Instance& k) {
+  const ChainReduction reduction = reduceChain(k);
+  if (reduction.reduced.size() < 3U) return expandReduction(reduction, {});
+  return expandReduction(reduction, exact(reduction.reduced));
+}
+
+}  // namespace mc
@@ -0,0 +1,62 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// A chain with the multiplications that Lemma 1 in (Chin 1978) proves to be
+// in an optimal order taken out. Those done before the reduced chain leave
+// one operand per pair of its consecutive dimensions, and those done after
+// combine its result with the operands nibbled off its ends, so any order of
+// the reduced chain completes a plan of the whole one, and an optimal one
+// completes an optimal plan.
+struct ChainReduction {
+  Instance reduced;             // Dimensions of the reduced chain, q.
+  std::vector<unsigned> index;  // q[i] is k[index[i]].
+  Permutation first;  // Forced multiplications done before those of q.
+  Permutation last;   // Forced multiplications done after those of q.
+  double forced_flops{0.0};  // Cost of first and last.
+};
+
+/**
+ * @brief Applies the reduction by Lemma 1 in (Chin 1978): a forward scan
+ * fixing the multiplications done first, then nibbling at both ends of the
+ * chain, fixing the ones done last. Runs in O(n).
+ *
+ * Throws std::invalid_argument if the instance has fewer than two dimensions.
+ *
+ * @param k                 Instance.
+ * @return ChainReduction   forced multiplications and reduced chain.
+ */
+ChainReduction reduceChain(const Instance& k);
+
+/**
+ * @brief Completes an order of computation of the reduced chain into a
+ * canonical one of the whole chain.
+ *
+ * Throws std::invalid_argument if the permutation does not match the reduced
+ * chain.
+ *
+ * @param reduction     reduction of the chain.
+ * @param reduced_perm  order of computation of reduction.reduced (its
+ * multiplications are indices into q).
+ * @return Permutation  canonical order of computation of the whole chain.
+ */
+Permutation expandReduction(const ChainReduction& reduction,
+                            const Permutation& reduced_perm);
+
+/**
+ * @brief Returns an optimal order of computation, running the exact DP on the
+ * reduced chain only: O(n + q^3) instead of O(n^3).
+ *
+ * @param k             Instance.
+ * @return Permutation  Canonical order of an optimal parenthesisation.
+ */
+Permutation reducedExact(const Instance& k);
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,175 @@
+#include "result_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+namespace {
+
+constexpr std::size_t io_buffer_size = 1U << 22;
+
+constexpr char magic[8] = {'M', 'C', 'R', 'E', 'S', '0', '1', '\0'};
+constexpr std::uint8_t type_uint32 = 0U;
+constexpr std::uint8_t type_double = 1U;
+
+void appendNumber(std::string& out, const double x) {
+  char digits[32];
+  auto res = std::to_chars(digits, digits + sizeof(digits), x);
+  out.append(digits, res.ptr);
+}
+
+void appendNumber(std::string& out, const unsigned x) {
+  char digits[16];
+  auto res = std::to_chars(digits, digits + sizeof(digits), x);
+  out.append(digits, res.ptr);
+}
+
+}  // namespace
+
+ResultWriter::ResultWriter(const std::string& path, const unsigned n,
+                           const std::vector<std::string>& approximations,
+                           const ExportFormat format,
+                           const unsigned rows_per_group)
+    : format{format},
+      n_dims{n + 1U},
+      n_approximations{static_cast<unsigned>(approximations.size())},
+      rows_per_group{std::max(1U, rows_per_group)},
+      io_buffer(io_buffer_size),
+      dims_columns(n + 1U),
+      cost_columns(approximations.size()),
+      penalty_columns(approximations.size()) {
+  file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr)
+    throw std::runtime_error("ResultWriter: cannot open " + path);
+  std::setvbuf(file, io_buffer.data(), _IOFBF, io_buffer.size());
+  writeHeader(approximations);
+}
+
+ResultWriter::~ResultWriter() {
+  flush();
+  std::fclose(file);
+}
+
+void ResultWriter::writeHeader(const std::vector<std::string>& approximations) {
+  std::vector<std::string> names;
+  std::vector<std::uint8_t> types;
+  for (unsigned i = 0U; i < n_dims; i++) {
+    names.push_back("k" + std::to_string(i));
+    types.push_back(type_uint32);
+  }
+  names.push_back("min_A");
+  types.push_back(type_double);
+  names.push_back("argmin_A");
+  types.push_back(type_uint32);
+  for (const auto& name : approximations) {
+    names.push_back(name + "_cost");
+    types.push_back(type_double);
+    names.push_back(name + "_penalty");
+    types.push_back(type_double);
+  }
+
+  if (format == ExportFormat::CSV) {
+    std::string line;
+    for (unsigned c = 0U; c < names.size(); c++) {
+      if (c) line.push_back(',');
+      line += names[c];
+    }
+    line.push_back('\n');
+    std::fwrite(line.data(), 1U, line.size(), file);
+    return;
+  }
+
+  std::fwrite(magic, 1U, sizeof(magic), file);
+  const std::uint32_t n_columns = names.size();
+  std::fwrite(&n_columns, sizeof(n_columns), 1U, file);
+  for (unsigned c = 0U; c < names.size(); c++) {
+    const std::uint32_t length = names[c].size();
+    std::fwrite(&types[c], sizeof(types[c]), 1U, file);
+    std::fwrite(&length, sizeof(length), 1U, file);
+    std::fwrite(names[c].data(), 1U, length, file);
+  }
+}
+
+void ResultWriter::write(const std::vector<Instance>& S,
+                         const std::vector<double>& min_A,
+                         const std::vector<unsigned>& argmin_A,
+                         const std::vector<std::vector<double>>& costs,
+                         const std::vector<std::vector<double>>& penalties) {
+  const unsigned N = S.size();
+  n_rows += N;
+  if (format == ExportFormat::CSV) {
+    for (unsigned first = 0U; first < N; first += rows_per_group)
+      writeCSV(S, first, std::min(N, first + rows_per_group), min_A, argmin_A,
+               costs, penalties);
+    return;
+  }
+
+  for (unsigned j = 0U; j < N; j++) {
+    for (unsigned i = 0U; i < n_dims; i++) dims_columns[i].push_back(S[j][i]);
+    min_A_column.push_back(min_A[j]);
+    argmin_A_column.push_back(argmin_A[j]);
+    for (unsigned a = 0U; a < n_approximations; a++) {
+      cost_columns[a].push_back(costs[a][j]);
+      penalty_columns[a].push_back(penalties[a][j]);
+    }
+    if (min_A_column.size() == rows_per_group) flush();
+  }
+}
+
+void ResultWriter::flush() {
+  if (format == ExportFormat::Binary and !min_A_column.empty()) {
+    const std::uint32_t rows = min_A_column.size();
+    std::fwrite(&rows, sizeof(rows), 1U, file);
+    for (auto& column : dims_columns) {
+      writeColumn(column);
+      column.clear();
+    }
+    writeColumn(min_A_column);
+    min_A_column.clear();
+    writeColumn(argmin_A_column);
+    argmin_A_column.clear();
+    for (unsigned a = 0U; a < n_approximations; a++) {
+      writeColumn(cost_columns[a]);
+      cost_columns[a].clear();
+      writeColumn(penalty_columns[a]);
+      penalty_columns[a].clear();
+    }
+  }
+  std::fflush(file);
+}
+
+void ResultWriter::writeCSV(const std::vector<Instance>& S,
+                            const unsigned first, const unsigned last,
+                            const std::vector<double>& min_A,
+                            const std::vector<unsigned>& argmin_A,
+                            const std::vector<std::vector<double>>& costs,
+                            const std::vector<std::vector<double>>& penalties) {
+  std::string out;
+  for (unsigned j = first; j < last; j++) {
+    for (unsigned i = 0U; i < n_dims; i++) {
+      appendNumber(out, S[j][i]);
+      out.push_back(',');
+    }
+    appendNumber(out, min_A[j]);
+    out.push_back(',');
+    appendNumber(out, argmin_A[j]);
+    for (unsigned a = 0U; a < n_approximations; a++) {
+      out.push_back(',');
+      appendNumber(out, costs[a][j]);
+      out.push_back(',');
+      appendNumber(out, penalties[a][j]);
+    }
+    out.push_back('\n');
+  }
+  std::fwrite(out.data(), 1U, out.size(), file);
+}
+
+}  // namespace mc
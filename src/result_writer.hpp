@@ -0,0 +1,101 @@
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Binary layout (native endianness):
+//  * header: the 8 bytes "MCRES01\0", uint32 number of columns, then per
+//    column a uint8 type (0 = uint32, 1 = double), a uint32 name length and
+//    the name.
+//  * row groups until the end of the file: uint32 number of rows r, then
+//    every column in header order as r contiguous values of its type.
+// Columns: k0 ... kn (uint32), min_A (double), argmin_A (uint32), and for
+// every approximation <name>_cost (double) and <name>_penalty (double).
+// The CSV fallback has a header line with the same column names.
+
+enum class ExportFormat { Binary, CSV };
+
+class ResultWriter {  // Streams per-instance results column by column.
+ private:
+  FILE* file;
+  ExportFormat format;
+  unsigned n_dims;
+  unsigned n_approximations;
+  unsigned rows_per_group;
+  std::vector<char> io_buffer;
+
+  // Columns of the row group being filled.
+  std::vector<std::vector<std::uint32_t>> dims_columns;
+  std::vector<double> min_A_column;
+  std::vector<std::uint32_t> argmin_A_column;
+  std::vector<std::vector<double>> cost_columns, penalty_columns;
+  std::uint64_t n_rows{0U};
+
+ public:
+  ResultWriter() = delete;
+  ResultWriter(const ResultWriter&) = delete;
+  ResultWriter& operator=(const ResultWriter&) = delete;
+
+  /**
+   * @brief Parametrised constructor. Opens the file and writes the header.
+   * Throws std::runtime_error if the file cannot be opened.
+   *
+   * @param path            output file.
+   * @param n               length of the chain.
+   * @param approximations  names of the approximation algorithms.
+   * @param format          binary columns or CSV.
+   * @param rows_per_group  rows buffered before a row group is written.
+   */
+  ResultWriter(const std::string& path, const unsigned n,
+               const std::vector<std::string>& approximations,
+               const ExportFormat format = ExportFormat::Binary,
+               const unsigned rows_per_group = 1U << 16);
+
+  // Writes the pending rows and closes the file.
+  ~ResultWriter();
+
+  /**
+   * @brief Appends one row per instance in S.
+   *
+   * @param S         instances, all of length n.
+   * @param min_A     minimum cost per instance.
+   * @param argmin_A  index of the cheapest parenthesisation per instance.
+   * @param costs     per approximation, its cost per instance.
+   * @param penalties per approximation, its penalty per instance.
+   */
+  void write(const std::vector<Instance>& S, const std::vector<double>& min_A,
+             const std::vector<unsigned>& argmin_A,
+             const std::vector<std::vector<double>>& costs,
+             const std::vector<std::vector<double>>& penalties);
+
+  // Writes the pending rows as a row group.
+  void flush();
+
+  // Getter for the number of rows written so far.
+  inline std::uint64_t getNumRows() const noexcept { return n_rows; }
+
+ private:
+  void writeHeader(const std::vector<std::string>& approximations);
+
+  void writeCSV(const std::vector<Instance>& S, const unsigned first,
+                const unsigned last, const std::vector<double>& min_A,
+                const std::vector<unsigned>& argmin_A,
+                const std::vector<std::vector<double>>& costs,
+                const std::vector<std::vector<double>>& penalties);
+
+  template <typename T>
+  void writeColumn(const std::vector<T>& column) {
+    std::fwrite(column.data(), sizeof(T), column.size(), file);
+  }
+};
+
+}  // namespace mc
+
+#endif
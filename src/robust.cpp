@@ -0,0 +1,222 @@
+#include "robust.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "analyzer.hpp"
+#include "definitions.hpp"
+#include "exact.hpp"
+#include "generator.hpp"
+#include "permutation.hpp"
+
+namespace mc {
+
+namespace {
+
+// Fills plan's metrics for the parenthesisation in row i of the matrix.
+void evaluate(const unsigned M, const unsigned N,
+              const std::vector<double>& cost_matrix, const unsigned i,
+              const std::vector<double>& min_A,
+              const std::vector<double>& weights, RobustPlan& plan) {
+  plan.worst_cost = plan.expected_cost = plan.worst_penalty = 0.0;
+  for (unsigned j = 0U; j < N; j++) {
+    const double cost = cost_matrix[j * M + i];
+    plan.worst_cost = std::max(plan.worst_cost, cost);
+    plan.expected_cost += weights[j] * cost;
+    plan.worst_penalty = std::max(plan.worst_penalty, penalty(min_A[j], cost));
+  }
+}
+
+double objectiveValue(const RobustPlan& plan, const RobustObjective objective) {
+  switch (objective) {
+    case RobustObjective::WorstCost:
+      return plan.worst_cost;
+    case RobustObjective::ExpectedCost:
+      return plan.expected_cost;
+    default:
+      return plan.worst_penalty;
+  }
+}
+
+}  // namespace
+
+std::vector<Instance> rangeVertices(const std::vector<DimensionRange>& ranges) {
+  std::vector<unsigned> uncertain;
+  Instance base(ranges.size());
+  for (unsigned i = 0U; i < ranges.size(); i++) {
+    if (ranges[i].lo > ranges[i].hi)
+      throw std::invalid_argument("rangeVertices: empty range");
+    base[i] = ranges[i].lo;
+    if (ranges[i].lo != ranges[i].hi) uncertain.push_back(i);
+  }
+  if (uncertain.size() > max_uncertain_dims)
+    throw std::length_error("rangeVertices: too many uncertain dimensions");
+
+  std::vector<Instance> vertices(1ULL << uncertain.size(), base);
+  for (unsigned v = 0U; v < vertices.size(); v++) {
+    for (unsigned b = 0U; b < uncertain.size(); b++) {
+      if (v >> b & 1U) vertices[v][uncertain[b]] = ranges[uncertain[b]].hi;
+    }
+  }
+  return vertices;
+}
+
+std::vector<unsigned> nonDominated(const unsigned M, const unsigned N,
+                                   const std::vector<double>& cost_matrix) {
+  // A parenthesisation can only be dominated by one with a smaller total, so
+  // sweeping by total, each one is checked against the front found so far.
+  std::vector<double> total(M, 0.0);
+  for (unsigned j = 0U; j < N; j++) {
+    for (unsigned i = 0U; i < M; i++) total[i] += cost_matrix[j * M + i];
+  }
+  std::vector<unsigned> order(M);
+  std::iota(order.begin(), order.end(), 0U);
+  std::stable_sort(order.begin(), order.end(),
+                   [&total](const unsigned a, const unsigned b) {
+                     return total[a] < total[b];
+                   });
+
+  std::vector<unsigned> front;
+  for (const auto& i : order) {
+    bool dominated = false;
+    for (unsigned f = 0U; f < front.size() and !dominated; f++) {
+      dominated = true;
+      for (unsigned j = 0U; j < N and dominated; j++)
+        dominated = cost_matrix[j * M + front[f]] <= cost_matrix[j * M + i];
+    }
+    if (!dominated) front.push_back(i);
+  }
+  std::sort(front.begin(), front.end());
+  return front;
+}
+
+RobustPlan robustPlan(const std::vector<Instance>& scenarios,
+                      const std::vector<double>& weights,
+                      const RobustObjective objective) {
+  if (scenarios.empty())
+    throw std::invalid_argument("robustPlan: no scenarios");
+  const unsigned n = scenarios[0].size() - 1U;
+  const unsigned N = scenarios.size();
+  for (const auto& scenario : scenarios) {
+    if (scenario.size() != n + 1U or n == 0U)
+      throw std::invalid_argument("robustPlan: scenarios of mixed lengths");
+  }
+  if (!weights.empty() and weights.size() != N)
+    throw std::invalid_argument("robustPlan: one weight per scenario needed");
+
+  std::vector<double> w = weights;
+  if (w.empty()) w.assign(N, 1.0);
+  const double sum = std::accumulate(w.begin(), w.end(), 0.0);
+  for (auto& x : w) x /= sum;
+
+  // Candidates and their cost on every scenario.
+  std::vector<Permutation> perms;
+  std::vector<double> cost_matrix;
+  if (n <= robust_enumeration_max and
+      catalanNumber(n - 1U) * N <= max_robust_matrix) {
+    auto A = generateAlgorithms(n);
+    cost_matrix = FLOPsOnInstances(A, scenarios);
+    for (const auto& alg : A) perms.push_back(alg.getPermutation());
+  } else {
+    // Every scenario's optimum is a candidate, so min_A below is still the
+    // optimal cost of every scenario.
+    std::map<Permutation, unsigned> unique;
+    for (const auto& scenario : scenarios)
+      unique.emplace(exact(scenario), 0U);
+    for (const auto& entry : unique) perms.push_back(entry.first);
+
+    const unsigned M = perms.size();
+    cost_matrix.resize(static_cast<std::size_t>(M) * N);
+    for (unsigned j = 0U; j < N; j++) {
+      for (unsigned i = 0U; i < M; i++)
+        cost_matrix[j * M + i] = permutationFlops(perms[i], scenarios[j]);
+    }
+  }
+  const unsigned M = perms.size();
+  const auto min_A = reduceCostMatrix(M, N, cost_matrix, {}, {}).min_A;
+
+  const std::vector<unsigned> candidates = nonDominated(M, N, cost_matrix);
+  RobustPlan best, plan;
+  double best_value = std::numeric_limits<double>::max();
+  for (const auto& i : candidates) {
+    evaluate(M, N, cost_matrix, i, min_A, w, plan);
+    const double value = objectiveValue(plan, objective);
+    if (value < best_value) {
+      best_value = value;
+      best = plan;
+      best.permutation = perms[i];
+    }
+  }
+  best.n_candidates = candidates.size();
+  return best;
+}
+
+RobustPlan robustPlan(const std::vector<DimensionRange>& ranges,
+                      const RobustObjective objective) {
+  if (ranges.size() < 2U)
+    throw std::invalid_argument("robustPlan: at least two dimensions needed");
+  if (objective == RobustObjective::WorstPenalty)
+    return robustPlan(rangeVertices(ranges), {}, objective);
+
+  // Upper corner, or the means (lo + hi) / 2, which can exceed an unsigned
+  // dimension, so the mean cost is planned in doubles.
+  const unsigned n = ranges.size() - 1U;
+  Instance upper(ranges.size());
+  std::vector<double> mean(ranges.size());
+  unsigned n_uncertain = 0U;
+  for (unsigned i = 0U; i <= n; i++) {
+    if (ranges[i].lo > ranges[i].hi)
+      throw std::invalid_argument("robustPlan: empty range");
+    upper[i] = ranges[i].hi;
+    mean[i] = 0.5 * (static_cast<double>(ranges[i].lo) + ranges[i].hi);
+    if (ranges[i].lo != ranges[i].hi) n_uncertain++;
+  }
+
+  RobustPlan plan;
+  plan.n_candidates = 1U;
+  if (objective == RobustObjective::WorstCost) {
+    plan.permutation = exact(upper);
+  } else {
+    std::vector<double> cost((n + 1U) * (n + 1U));
+    std::vector<unsigned> split((n + 1U) * (n + 1U)), stack(2U * (n + 1U));
+    intervalSplits(
+        n,
+        [&mean](const unsigned i, const unsigned s, const unsigned j) {
+          return mean[i] * mean[s] * mean[j];
+        },
+        cost.data(), split.data());
+    plan.permutation.resize(n - 1U);
+    splitsToOrder(n, split.data(), stack.data(), plan.permutation.data());
+  }
+
+  // Metrics over the vertices when they can be enumerated. The mean of a
+  // multilinear cost over the vertices equals its value at the means.
+  if (n_uncertain > max_uncertain_dims) {
+    plan.worst_cost = permutationFlops(plan.permutation, upper);
+    plan.expected_cost = 0.0;
+    visitOrder(plan.permutation, n,
+               [&](const unsigned, const unsigned lo, const unsigned p,
+                   const unsigned hi) {
+                 plan.expected_cost += mean[lo] * mean[p] * mean[hi];
+               });
+    plan.worst_penalty = std::numeric_limits<double>::quiet_NaN();
+    return plan;
+  }
+  const std::vector<Instance> vertices = rangeVertices(ranges);
+  std::vector<double> min_A(vertices.size());
+  for (unsigned j = 0U; j < vertices.size(); j++)
+    min_A[j] = exactCost(vertices[j]);
+  std::vector<double> cost(vertices.size());
+  for (unsigned j = 0U; j < vertices.size(); j++)
+    cost[j] = permutationFlops(plan.permutation, vertices[j]);
+  evaluate(1U, vertices.size(), cost, 0U, min_A,
+           std::vector<double>(vertices.size(), 1.0 / vertices.size()), plan);
+  return plan;
+}
+
+}  // namespace mc
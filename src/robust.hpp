@@ -0,0 +1,116 @@
+#ifndef ROBUST_H
+#define ROBUST_H
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Chains up to this length are planned over all parenthesisations, as long
+// as the cost matrix has at most max_robust_matrix entries; longer chains use
+// the optimal parenthesisation of every scenario as candidates.
+constexpr unsigned robust_enumeration_max = 10U;
+constexpr unsigned long long max_robust_matrix = 1ULL << 24;
+
+// Dimensions with uncertain ranges up to this count are expanded to all the
+// vertices of the box (2^count scenarios).
+constexpr unsigned max_uncertain_dims = 16U;
+
+struct DimensionRange {  // Closed interval of sizes for one dimension.
+  unsigned lo{1U}, hi{1U};
+
+  DimensionRange() = default;
+
+  DimensionRange(const unsigned lo, const unsigned hi) : lo{lo}, hi{hi} {}
+};
+
+enum class RobustObjective {
+  WorstCost,     // Minimise the maximum cost across scenarios.
+  ExpectedCost,  // Minimise the (weighted) mean cost.
+  WorstPenalty   // Minimise the maximum penalty w.r.t. each scenario's optimum.
+};
+
+struct RobustPlan {
+  Permutation permutation;   // Canonical order of computation.
+  double worst_cost{0.0};    // Maximum cost across scenarios.
+  double expected_cost{0.0};  // Weighted mean cost.
+  double worst_penalty{0.0};  // Maximum penalty across scenarios.
+  unsigned n_candidates{0U};  // Non-dominated candidates considered.
+};
+
+// The cost of a fixed parenthesisation is a multilinear polynomial with
+// positive coefficients in the dimensions (every term is a product of three
+// distinct ones). Hence, over a box of ranges:
+//  * its maximum is attained at the upper corner;
+//  * its mean under independent dimensions is its value at the means;
+//  * its penalty against any other parenthesisation, a ratio of such
+//    polynomials, is monotone along every dimension, so the worst penalty is
+//    attained at a vertex of the box.
+
+/**
+ * @brief Returns the vertices of the box of ranges: one instance per
+ * combination of lo/hi of the dimensions whose range is not a single value.
+ * Throws std::length_error if there are more than max_uncertain_dims of them.
+ *
+ * @param ranges                  n+1 ranges, one per dimension.
+ * @return std::vector<Instance>  2^(uncertain dimensions) instances.
+ */
+std::vector<Instance> rangeVertices(const std::vector<DimensionRange>& ranges);
+
+/**
+ * @brief Returns the indices of the parenthesisations that are not dominated,
+ * i.e. for which no other one is at most as expensive on every scenario and
+ * cheaper on at least one. Duplicated cost rows are kept once. No robust
+ * objective ever prefers a dominated parenthesisation.
+ *
+ * @param M                       number of parenthesisations.
+ * @param N                       number of scenarios.
+ * @param cost_matrix             MxN matrix in a vector (see
+ * FLOPsOnInstances).
+ * @return std::vector<unsigned>  indices of the non-dominated ones, ascending.
+ */
+std::vector<unsigned> nonDominated(const unsigned M, const unsigned N,
+                                   const std::vector<double>& cost_matrix);
+
+/**
+ * @brief Returns the parenthesisation that optimises the objective across the
+ * passed scenarios, all of the same length.
+ *
+ * The cost of the candidates is evaluated on all scenarios at once, dominated
+ * candidates are pruned and the objective is evaluated on the rest. Throws
+ * std::invalid_argument for empty or mixed-length scenarios.
+ *
+ * @param scenarios   instances the plan has to cope with.
+ * @param weights     probability of every scenario (empty = uniform); only
+ * used by the expected cost.
+ * @param objective   RobustObjective.
+ * @return RobustPlan
+ */
+RobustPlan robustPlan(const std::vector<Instance>& scenarios,
+                      const std::vector<double>& weights,
+                      const RobustObjective objective);
+
+/**
+ * @brief Returns the parenthesisation that optimises the objective over the
+ * box of ranges, with independent and uniformly distributed dimensions for
+ * the expected cost.
+ *
+ * The worst and expected costs are minimised exactly with one O(n^3) dynamic
+ * programming (on the upper corner and on the means); the worst penalty is
+ * planned over the vertices of the box (see rangeVertices), so it throws
+ * std::length_error with more than max_uncertain_dims uncertain dimensions.
+ * The reported metrics are computed over the vertices; beyond that many
+ * uncertain dimensions, the worst and expected costs are computed on the
+ * upper corner and the means instead, and worst_penalty is NaN.
+ *
+ * @param ranges      n+1 ranges, one per dimension.
+ * @param objective   RobustObjective.
+ * @return RobustPlan
+ */
+RobustPlan robustPlan(const std::vector<DimensionRange>& ranges,
+                      const RobustObjective objective);
+
+}  // namespace mc
+
+#endif
@@ -0,0 +1,96 @@
+#include "sparse.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.hpp"
+#include "property_chain.hpp"
+
+namespace mc {
+
+SparseInstance::SparseInstance(const Instance& dims,
+                               const std::vector<double>& densities)
+    : dims{dims}, densities{densities} {
+  if (densities.size() + 1U != dims.size())
+    throw std::invalid_argument("SparseInstance: need one density per factor");
+  for (const auto& d : densities) {
+    if (!(d > 0.0 and d <= 1.0))
+      throw std::invalid_argument("SparseInstance: densities must be in "
+                                  "(0, 1]");
+  }
+}
+
+double estimatedDensity(const double paths) { return -std::expm1(-paths); }
+
+double sparseCostMult(const unsigned m, const unsigned k, const unsigned n,
+                      const double d_left, const double d_right,
+                      const double dense_threshold) {
+  const double mkn = static_cast<double>(m) * static_cast<double>(k) *
+                     static_cast<double>(n);
+  const bool sparse_left = d_left <= dense_threshold;
+  const bool sparse_right = d_right <= dense_threshold;
+
+  if (sparse_left and sparse_right) return mkn * d_left * d_right;  // SpGEMM
+  if (sparse_left) return mkn * d_left;                             // SpMM
+  if (sparse_right) return mkn * d_right;                           // SpMM
+  return mkn;                                                       // GEMM
+}
+
+namespace {
+
+struct Density {  // Expected nonzero paths per entry, and estimated density.
+  double paths, density;
+};
+
+struct SparseModel {  // Model of property_chain.hpp.
+  using Property = Density;
+  const Instance& dims;
+  const std::vector<double>& densities;
+  const double dense_threshold;
+
+  SparseModel(const SparseInstance& instance, const double dense_threshold)
+      : dims{instance.dims},
+        densities{instance.densities},
+        dense_threshold{dense_threshold} {}
+
+  Density leaf(const unsigned i) const { return {densities[i], densities[i]}; }
+  Density general() const {
+    return {std::numeric_limits<double>::infinity(), 1.0};
+  }
+  Density product(const Density& left, const unsigned k,
+                  const Density& right) const {
+    const double paths = left.paths * k * right.paths;
+    return {paths, estimatedDensity(paths)};
+  }
+  double multCost(const unsigned m, const unsigned k, const unsigned n,
+                  const Density& left, const Density& right) const {
+    return sparseCostMult(m, k, n, left.density, right.density,
+                          dense_threshold);
+  }
+};
+
+}  // namespace
+
+double sparseCost(const Permutation& perm, const SparseInstance& instance,
+                  const double dense_threshold) {
+  return propertyCost(SparseModel{instance, dense_threshold}, perm);
+}
+
+Permutation sparseExact(const SparseInstance& instance,
+                        const double dense_threshold) {
+  return propertyExact(SparseModel{instance, dense_threshold});
+}
+
+Permutation sparseMinEssential(const SparseInstance& instance,
+                               const double dense_threshold) {
+  return propertyMinEssential(SparseModel{instance, dense_threshold});
+}
+
+Permutation sparseReduceMin(const SparseInstance& instance,
+                            const double dense_threshold) {
+  return propertyReduceMin(SparseModel{instance, dense_threshold});
+}
+
+}  // namespace mc
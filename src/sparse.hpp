@@ -0,0 +1,119 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+// Operands with a density above this threshold are multiplied as dense.
+constexpr double default_dense_threshold = 0.1;
+
+struct SparseInstance {
+  Instance dims;                  // n+1 dimensions, as in Instance.
+  std::vector<double> densities;  // n densities (nnz / size) in (0, 1].
+
+  SparseInstance() = default;
+
+  /**
+   * @brief Parametrised constructor. Throws std::invalid_argument if the sizes
+   * do not match or a density is not in (0, 1].
+   *
+   * @param dims      vector<unsigned> - sizes of the chain.
+   * @param densities density of every factor.
+   */
+  SparseInstance(const Instance& dims, const std::vector<double>& densities);
+};
+
+// Densities are propagated through products as the expected number of
+// nonzero paths per entry of the result: a factor contributes its density,
+// and the product of two operands with inner dimension k has
+// paths(left) * k * paths(right). With independently distributed nonzeros
+// this count is exact and, unlike chaining the pairwise estimate
+// 1 - (1 - dl * dr)^k, it does not depend on the parenthesisation, so the
+// dynamic programming below is exact for the estimates.
+
+/**
+ * @brief Estimates the density of an intermediate from its expected number of
+ * nonzero paths per entry (Poisson approximation: 1 - exp(-paths)).
+ *
+ * @param paths   expected number of nonzero paths per entry.
+ * @return double estimated density.
+ */
+double estimatedDensity(const double paths);
+
+/**
+ * @brief Returns the cost of multiplying a (m x k) matrix with density d_left
+ * by a (k x n) matrix with density d_right, in the same unit as m * k * n.
+ *
+ * Each operand counts as sparse if its density is at most dense_threshold.
+ * Two sparse operands are multiplied as SpGEMM (m * k * n * dl * dr), one
+ * sparse operand as SpMM (nnz of the sparse operand times the other outer
+ * dimension), and two dense operands as GEMM (m * k * n).
+ *
+ * @param m               unsigned - number of rows of the left matrix.
+ * @param k               unsigned - number of columns of the left matrix.
+ * @param n               unsigned - number of columns of the right matrix.
+ * @param d_left          density of the left matrix.
+ * @param d_right         density of the right matrix.
+ * @param dense_threshold density above which an operand is dense.
+ * @return double         cost of the multiplication.
+ */
+double sparseCostMult(const unsigned m, const unsigned k, const unsigned n,
+                      const double d_left, const double d_right,
+                      const double dense_threshold = default_dense_threshold);
+
+/**
+ * @brief Returns the estimated cost of the order of computation on the sparse
+ * instance, propagating the estimated densities through its tree
+ * (propertyCost). Runs in O(n). Throws std::invalid_argument if perm is not
+ * an order of computation of the chain.
+ *
+ * @param perm            order of computation.
+ * @param instance        SparseInstance.
+ * @param dense_threshold density above which an operand is dense.
+ * @return double         estimated cost.
+ */
+double sparseCost(const Permutation& perm, const SparseInstance& instance,
+                  const double dense_threshold = default_dense_threshold);
+
+/**
+ * @brief Returns an optimal order of computation under the sparse cost
+ * (O(n^3) dynamic programming, propertyExact).
+ *
+ * @param instance        SparseInstance.
+ * @param dense_threshold density above which an operand is dense.
+ * @return Permutation    Canonical order of computation.
+ */
+Permutation sparseExact(const SparseInstance& instance,
+                        const double dense_threshold = default_dense_threshold);
+
+/**
+ * @brief Returns the cheapest essential parenthesisation under the sparse
+ * cost among those costed by propertyMinEssential. Runs in O(n).
+ *
+ * @param instance        SparseInstance.
+ * @param dense_threshold density above which an operand is dense.
+ * @return Permutation    Yielded order of computation.
+ */
+Permutation sparseMinEssential(
+    const SparseInstance& instance,
+    const double dense_threshold = default_dense_threshold);
+
+/**
+ * @brief Algorithm 3 under the sparse cost (propertyReduceMin): the
+ * reduction and the choice of the essential parenthesisation both compare
+ * sparse costs. Runs in O(n).
+ *
+ * @param instance        SparseInstance.
+ * @param dense_threshold density above which an operand is dense.
+ * @return Permutation    Yielded order of computation.
+ */
+Permutation sparseReduceMin(
+    const SparseInstance& instance,
+    const double dense_threshold = default_dense_threshold);
+
+}  // namespace mc
+
+#endif
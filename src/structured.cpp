@@ -0,0 +1,107 @@
+#include "structured.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include "definitions.hpp"
+#include "property_chain.hpp"
+
+namespace mc {
+
+namespace {
+
+struct StructuredModel {  // Model of property_chain.hpp.
+  using Property = Structure;
+  const Instance& dims;
+  const std::vector<Operand>& operands;
+
+  explicit StructuredModel(const StructuredInstance& instance)
+      : dims{instance.dims}, operands{instance.operands} {}
+
+  Structure leaf(const unsigned i) const {
+    return effectiveStructure(operands[i]);
+  }
+  Structure general() const { return Structure::General; }
+  Structure product(const Structure left, const unsigned,
+                    const Structure right) const {
+    return productStructure(left, right);
+  }
+  double multCost(const unsigned m, const unsigned k, const unsigned n,
+                  const Structure left, const Structure right) const {
+    return structuredCostMult(m, k, n, left, right);
+  }
+};
+
+}  // namespace
+
+StructuredInstance::StructuredInstance(const Instance& dims,
+                                       const std::vector<Operand>& operands)
+    : dims{dims}, operands{operands} {
+  if (operands.size() + 1U != dims.size())
+    throw std::invalid_argument("StructuredInstance: need one operand per "
+                                "factor");
+  for (unsigned i = 0U; i < operands.size(); i++) {
+    if (operands[i].structure != Structure::General and
+        dims[i] != dims[i + 1U])
+      throw std::invalid_argument("StructuredInstance: structured factors "
+                                  "must be square");
+  }
+}
+
+Structure effectiveStructure(const Operand& operand) {
+  if (!operand.transposed) return operand.structure;
+  if (operand.structure == Structure::Lower) return Structure::Upper;
+  if (operand.structure == Structure::Upper) return Structure::Lower;
+  return operand.structure;
+}
+
+Structure productStructure(const Structure left, const Structure right) {
+  if (left == Structure::Diagonal and right == Structure::Diagonal)
+    return Structure::Diagonal;
+  if ((left == Structure::Lower or left == Structure::Diagonal) and
+      (right == Structure::Lower or right == Structure::Diagonal))
+    return Structure::Lower;
+  if ((left == Structure::Upper or left == Structure::Diagonal) and
+      (right == Structure::Upper or right == Structure::Diagonal))
+    return Structure::Upper;
+  return Structure::General;
+}
+
+double structuredCostMult(const unsigned m, const unsigned k, const unsigned n,
+                          const Structure left, const Structure right) {
+  const double mkn = static_cast<double>(m) * static_cast<double>(k) *
+                     static_cast<double>(n);
+  auto triangular = [](const Structure s) {
+    return s == Structure::Lower or s == Structure::Upper;
+  };
+
+  if (left == Structure::Diagonal and right == Structure::Diagonal)
+    return static_cast<double>(m);
+  if (left == Structure::Diagonal)
+    return static_cast<double>(k) * static_cast<double>(n);
+  if (right == Structure::Diagonal)
+    return static_cast<double>(m) * static_cast<double>(k);
+  if (triangular(left) and triangular(right))
+    return (left == right) ? mkn / 6.0 : mkn / 3.0;
+  if (triangular(left) or triangular(right)) return mkn / 2.0;
+  return mkn;
+}
+
+double structuredCost(const Permutation& perm,
+                      const StructuredInstance& instance) {
+  return propertyCost(StructuredModel{instance}, perm);
+}
+
+Permutation structuredExact(const StructuredInstance& instance) {
+  return propertyExact(StructuredModel{instance});
+}
+
+Permutation structuredMinEssential(const StructuredInstance& instance) {
+  return propertyMinEssential(StructuredModel{instance});
+}
+
+Permutation structuredReduceMin(const StructuredInstance& instance) {
+  return propertyReduceMin(StructuredModel{instance});
+}
+
+}  // namespace mc
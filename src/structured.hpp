@@ -0,0 +1,125 @@
+#ifndef STRUCTURED_H
+#define STRUCTURED_H
+
+#include <cstdint>
+#include <vector>
+
+#include "definitions.hpp"
+
+namespace mc {
+
+enum class Structure : uint8_t { General, Lower, Upper, Symmetric, Diagonal };
+
+struct Operand {  // Properties of one factor of the chain.
+  Structure structure{Structure::General};
+  bool transposed{false};
+
+  Operand() = default;
+
+  Operand(const Structure structure, const bool transposed = false)
+      : structure{structure}, transposed{transposed} {}
+};
+
+struct StructuredInstance {
+  Instance dims;                  // n+1 dimensions, as in Instance.
+  std::vector<Operand> operands;  // n operands, one per factor.
+
+  StructuredInstance() = default;
+
+  /**
+   * @brief Parametrised constructor. Throws std::invalid_argument if the sizes
+   * do not match or a non-general factor is not square.
+   *
+   * @param dims      vector<unsigned> - sizes of the chain.
+   * @param operands  properties of every factor.
+   */
+  StructuredInstance(const Instance& dims,
+                     const std::vector<Operand>& operands);
+};
+
+/**
+ * @brief Returns the structure of the operand once its transposition is
+ * applied (the transpose of a lower triangular matrix is upper triangular).
+ *
+ * @param operand     Operand.
+ * @return Structure  effective structure.
+ */
+Structure effectiveStructure(const Operand& operand);
+
+/**
+ * @brief Returns the structure of the product of two matrices.
+ *
+ * Products keep the zero patterns both factors share: lower * lower is lower,
+ * diagonal * upper is upper, diagonal * diagonal is diagonal and anything
+ * else is general. The rule is associative, so the structure of a product
+ * does not depend on its parenthesisation.
+ *
+ * @param left        structure of the left factor.
+ * @param right       structure of the right factor.
+ * @return Structure  structure of the product.
+ */
+Structure productStructure(const Structure left, const Structure right);
+
+/**
+ * @brief Returns the cost of multiplying a (m x k) matrix with structure left
+ * by a (k x n) matrix with structure right, in the same unit as m * k * n.
+ *
+ * Diagonal factors cost a scaling (k * n or m * k), a triangular factor
+ * (TRMM) halves the cost, two triangular factors cost m * k * n / 6 (same
+ * triangle) or / 3 (opposite triangles). Symmetric factors (SYMM) cost the
+ * same as general ones.
+ *
+ * @param m       unsigned - number of rows of the left matrix.
+ * @param k       unsigned - number of columns of the left matrix.
+ * @param n       unsigned - number of columns of the right matrix.
+ * @param left    structure of the left matrix.
+ * @param right   structure of the right matrix.
+ * @return double cost of the multiplication.
+ */
+double structuredCostMult(const unsigned m, const unsigned k, const unsigned n,
+                          const Structure left, const Structure right);
+
+/**
+ * @brief Returns the cost of the order of computation on the structured
+ * instance, propagating the structure of the operands through its tree
+ * (propertyCost). Runs in O(n). Throws std::invalid_argument if perm is not
+ * an order of computation of the chain.
+ *
+ * @param perm      order of computation.
+ * @param instance  StructuredInstance.
+ * @return double   cost.
+ */
+double structuredCost(const Permutation& perm,
+                      const StructuredInstance& instance);
+
+/**
+ * @brief Returns an optimal order of computation under the structured cost
+ * (O(n^3) dynamic programming, propertyExact).
+ *
+ * @param instance      StructuredInstance.
+ * @return Permutation  Canonical order of an optimal parenthesisation.
+ */
+Permutation structuredExact(const StructuredInstance& instance);
+
+/**
+ * @brief Returns the cheapest essential parenthesisation under the
+ * structured cost among those costed by propertyMinEssential. Runs in O(n).
+ *
+ * @param instance      StructuredInstance.
+ * @return Permutation  Yielded order of computation.
+ */
+Permutation structuredMinEssential(const StructuredInstance& instance);
+
+/**
+ * @brief Algorithm 3 under the structured cost (propertyReduceMin): the
+ * reduction and the choice of the essential parenthesisation both compare
+ * structured costs. Runs in O(n).
+ *
+ * @param instance      StructuredInstance.
+ * @return Permutation  Yielded order of computation.
+ */
+Permutation structuredReduceMin(const StructuredInstance& instance);
+
+}  // namespace mc
+
+#endif
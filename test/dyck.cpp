@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/dyck.hpp"
+#include "../src/exact.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples;
+  if (argc < 3) {
+    std::cerr << "Usage: ./dyck n n_samples\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const std::vector<mc::DyckWord> words =
+      mc::generateDyckWords<mc::DyckWord>(n);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Parenthesisations: " << words.size() << " ("
+            << words.size() * sizeof(mc::DyckWord) / double(1 << 20)
+            << " MiB) generated in "
+            << std::chrono::duration<double>(end - start).count() << " s\n";
+
+  const std::unordered_set<mc::DyckWord, mc::DyckHash> unique(words.begin(),
+                                                              words.end());
+  std::cout << "Distinct words: " << unique.size() << "\n";
+
+  // Exhaustive search straight from the bits, checked against the DP.
+  mc::Analyzer analyzer(1U, 1000U);
+  unsigned n_mismatches = 0U;
+  double seconds = 0.0;
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance k = analyzer.randomInstance(n);
+    start = std::chrono::steady_clock::now();
+    double best = std::numeric_limits<double>::max();
+    for (const auto& word : words)
+      best = std::min(best, mc::dyckFlops(word, k));
+    end = std::chrono::steady_clock::now();
+    seconds += std::chrono::duration<double>(end - start).count();
+    if (std::abs(best - mc::exactCost(k)) > 1e-9 * best) n_mismatches++;
+  }
+  std::cout << "ns per tree evaluated: "
+            << 1e9 * seconds / (static_cast<double>(words.size()) * n_samples)
+            << "\nMismatches with the DP: " << n_mismatches << " / "
+            << n_samples << "\n";
+}
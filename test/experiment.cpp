@@ -1,12 +1,15 @@
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <memory>
+#include <string>
 #include <vector>
 
-#include "../src/algorithm.hpp"
 #include "../src/analyzer.hpp"
-#include "../src/apprx_algorithms.hpp"
+#include "../src/apprx_registry.hpp"
+#include "../src/cost_models.hpp"
 #include "../src/definitions.hpp"
-#include "../src/generator.hpp"
+#include "../src/engine.hpp"
+#include "../src/result_writer.hpp"
 
 std::ostream& operator<<(std::ostream& os, const mc::Permutation& perm) {
   os << "[";
@@ -18,56 +21,116 @@ std::ostream& operator<<(std::ostream& os, const mc::Permutation& perm) {
 }
 
 int main(int argc, char** argv) {
-  unsigned n, n_samples;
-  if (argc < 3) {
-    std::cerr << "Usage: ./experiment n n_samples\n";
+  unsigned n, n_samples, batch_size = 10'000U;
+  double tolerance = 0.0;
+  std::string model = "flops", export_path;
+  mc::ExportFormat export_format = mc::ExportFormat::Binary;
+
+  // Options go first; the rest are positional.
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (i + 1 < argc and arg == "-o") {
+      export_path = argv[++i];
+    } else if (arg == "-csv") {
+      export_format = mc::ExportFormat::CSV;
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  if (args.size() < 2U) {
+    std::cerr << "Usage: ./experiment [-o file [-csv]] n n_samples "
+                 "[flops|bytes|roofline|table] [tolerance] [batch_size]\n";
     exit(-1);
   } else {
-    n = std::stoi(argv[1]);
-    n_samples = std::stoi(argv[2]);
+    n = std::stoi(args[0]);
+    n_samples = std::stoi(args[1]);
+    if (args.size() > 2U) model = args[2];
+    if (args.size() > 3U) tolerance = std::stod(args[3]);
+    if (args.size() > 4U) batch_size = std::stoi(args[4]);
   }
 
-  auto A = mc::generateAlgorithms(n);
-  mc::Analyzer analyzer(1U, 1000U);
+  // With a tolerance, n_samples is the budget: instances are drawn in batches
+  // until every 95% confidence interval is within the tolerance.
+  const bool early_stopping = tolerance > 0.0;
+  constexpr double z = 1.96;
+  if (!early_stopping) batch_size = n_samples;
 
-  std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+  const std::vector<mc::Approximation>& approximations =
+      mc::getApproximations();
+  std::unique_ptr<mc::ExperimentEngine> engine;
+  if (model == "flops") {
+    engine = std::make_unique<mc::ExperimentEngine>(n, approximations,
+                                                    mc::FlopsModel{});
+  } else if (model == "bytes") {
+    engine = std::make_unique<mc::ExperimentEngine>(n, approximations,
+                                                    mc::BytesModel{});
+  } else if (model == "roofline") {
+    engine = std::make_unique<mc::ExperimentEngine>(n, approximations,
+                                                    mc::RooflineModel{});
+  } else if (model == "table") {
+    engine = std::make_unique<mc::ExperimentEngine>(
+        n, approximations,
+        mc::TableModel::calibrate({1U, 10U, 100U, 1000U}, 3U));
+  } else {
+    std::cerr << "Unknown cost model: " << model << "\n";
+    exit(-1);
+  }
+  mc::Analyzer analyzer(1U, 1000U);
 
-  auto essential_perms = mc::getEssentialPerms(n);
-  std::set<unsigned> E;  // set of indices of essential parenthesisations.
-  for (const auto& perm : essential_perms) E.insert(mc::getID(A, perm));
+  std::cout << "M: " << engine->getNumAlgorithms() << "\n";
+  if (!early_stopping) std::cout << "N: " << n_samples << "\n";
+  std::cout << "Cost model: " << model << "\n";
 
-  const unsigned M = A.size();
-  const unsigned N = S.size();
-  std::cout << "M: " << M << "\n";
-  std::cout << "N: " << N << "\n";
+  // Every registered approximation, in registry order.
+  std::vector<std::string> names, labels;
+  for (const auto& apprx : approximations) {
+    names.push_back(apprx.name);
+    labels.push_back(apprx.label + ":");
+  }
 
-  auto cost_matrix = mc::FLOPsOnInstances(A, S);
-  auto perm2index = mc::getMapPerm2Index(A);
-  auto min_A = mc::getMinA(M, N, cost_matrix);
+  // Per-instance results, streamed batch by batch.
+  std::unique_ptr<mc::ResultWriter> writer;
+  if (!export_path.empty())
+    writer = std::make_unique<mc::ResultWriter>(export_path, n, names,
+                                                export_format);
 
-  // Essentials
-  auto min_E = mc::getMinZ(M, N, cost_matrix, E);
-  auto penalty_E = mc::getPenaltyZ(N, min_A, min_E);
-  mc::printMetrics(penalty_E, "Essentials:");
+  // At least min_batches batches, and enough non-zero penalties for every
+  // approximation, before trusting the intervals.
+  constexpr unsigned min_batches = 2U;
+  unsigned n_batches = 0U;
+  auto converged = [&]() {
+    if (n_batches < min_batches) return false;
+    for (const auto& s : engine->getStats()) {
+      if (!s.converged(z, tolerance)) return false;
+    }
+    return true;
+  };
 
-  using AlgMCP = std::function<mc::Permutation(const mc::Instance&)>;
+  unsigned long long N = 0U;
+  do {
+    const unsigned N_batch =
+        std::min<unsigned long long>(batch_size, n_samples - N);
+    std::vector<mc::Instance> S = analyzer.randomInstances(n, N_batch);
+    N += N_batch;
+    n_batches++;
 
-  // Chandra's
-  AlgMCP chandra = mc::chandra;
-  auto cost_chandra =
-      mc::getCostFromApprx(A, S, cost_matrix, perm2index, chandra);
-  auto penalty_chandra = mc::getPenaltyZ(N, min_A, cost_chandra);
-  mc::printMetrics(penalty_chandra, "Chandra's:");
+    // One pass over the instances for all approximations and metrics.
+    const mc::EngineBatch batch = engine->run(S);
+    if (writer)
+      writer->write(S, batch.min_A, batch.argmin_A, batch.costs,
+                    batch.penalties);
 
-  // Chin's
-  AlgMCP chin = mc::chin;
-  auto cost_chin = mc::getCostFromApprx(A, S, cost_matrix, perm2index, chin);
-  auto penalty_chin = mc::getPenaltyZ(N, min_A, cost_chin);
-  mc::printMetrics(penalty_chin, "Chin's:");
+    if (!early_stopping) {
+      for (unsigned a = 0U; a < labels.size(); a++)
+        mc::printMetrics(batch.penalties[a], labels[a]);
+      return 0;
+    }
+  } while (N < n_samples and !converged());
 
-  // // Reduce and minimize
-  AlgMCP rnm = mc::reduceMin;
-  auto cost_rnm = mc::getCostFromApprx(A, S, cost_matrix, perm2index, rnm);
-  auto penalty_rnm = mc::getPenaltyZ(N, min_A, cost_rnm);
-  mc::printMetrics(penalty_rnm, "Algorithm 3:");
-}
\ No newline at end of file
+  std::cout << "N: " << N << (converged() ? " (converged)" : " (budget)")
+            << "\n";
+  for (unsigned a = 0U; a < labels.size(); a++)
+    mc::printMetrics(engine->getStats()[a], labels[a], z);
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/incremental.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples;
+  if (argc < 3) {
+    std::cerr << "Usage: ./incremental n n_samples\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+  }
+
+  // Builds every chain factor by factor, planning after each append, then
+  // pops half of it and plans again, checking every plan against exact.
+  mc::Analyzer analyzer(1U, 1000U);
+  double incremental_seconds = 0.0, replan_seconds = 0.0;
+  unsigned n_plans = 0U, n_mismatches = 0U;
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance k = analyzer.randomInstance(n);
+    mc::IncrementalPlanner planner;
+    planner.reserve(n);
+    mc::Instance prefix;
+    for (unsigned j = 0U; j <= n; j++) {
+      auto start = std::chrono::steady_clock::now();
+      planner.push(k[j]);
+      const mc::Permutation plan = planner.getPlan();
+      auto end = std::chrono::steady_clock::now();
+      incremental_seconds += std::chrono::duration<double>(end - start).count();
+
+      prefix.push_back(k[j]);
+      if (prefix.size() < 3U) continue;
+      start = std::chrono::steady_clock::now();
+      const mc::Permutation expected = mc::exact(prefix);
+      end = std::chrono::steady_clock::now();
+      replan_seconds += std::chrono::duration<double>(end - start).count();
+      n_plans++;
+      if (plan != expected or planner.getCost() != mc::exactCost(prefix))
+        n_mismatches++;
+    }
+    for (unsigned j = 0U; j < n / 2U; j++) planner.pop();
+    prefix.resize(planner.getInstance().size());
+    if (prefix.size() >= 3U) {
+      n_plans++;
+      if (planner.getPlan() != mc::exact(prefix)) n_mismatches++;
+    }
+  }
+  std::cout << "Average time per append and plan (us): "
+            << 1e6 * incremental_seconds / (n_samples * (n + 1U))
+            << "\nAverage time per replan with exact (us): "
+            << 1e6 * replan_seconds / (n_samples * (n - 1U))
+            << "\nPlans differing from exact: " << n_mismatches << " / "
+            << n_plans << "\n";
+}
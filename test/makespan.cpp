@@ -0,0 +1,53 @@
+#include <iostream>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/makespan.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples, n_workers = 4U;
+  if (argc < 3) {
+    std::cerr << "Usage: ./makespan n n_samples [n_workers]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) n_workers = std::stoi(argv[3]);
+  }
+
+  mc::Analyzer analyzer(1U, 1000U);
+  const std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+  const unsigned N = S.size();
+
+  std::vector<double> min_flops(N), plan_flops(N), plan_makespan(N),
+      plan_path(N);
+  for (unsigned j = 0U; j < N; j++) {
+    const mc::ParallelPlan plan = mc::planMakespan(S[j], n_workers);
+    min_flops[j] = mc::exactCost(S[j]);
+    plan_flops[j] = plan.flops;
+    plan_makespan[j] = plan.makespan;
+    plan_path[j] = plan.critical_path;
+  }
+
+  // Wall-time penalties are relative to the makespan-aware plan.
+  mc::printMetrics(
+      mc::getPenaltyZ(N, plan_makespan,
+                      mc::getMakespanFromApprx(S, mc::exact, n_workers)),
+      "Wall-time penalty, FLOP-optimal:");
+  mc::printMetrics(
+      mc::getPenaltyZ(N, plan_makespan,
+                      mc::getMakespanFromApprx(S, mc::chandra, n_workers)),
+      "Wall-time penalty, chandra:");
+  mc::printMetrics(mc::getPenaltyZ(N, min_flops, plan_flops),
+                   "FLOP penalty, makespan-aware:");
+
+  const std::vector<double> exact_path =
+      mc::getCriticalPathFromApprx(S, mc::exact);
+  double path_ratio = 0.0;
+  for (unsigned j = 0U; j < N; j++) path_ratio += plan_path[j] / exact_path[j];
+  std::cout << "\navg critical path, makespan-aware / FLOP-optimal: "
+            << path_ratio / N << "\n";
+}
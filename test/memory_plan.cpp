@@ -0,0 +1,45 @@
+#include <iostream>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/memory_plan.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples, min_size = 1U, max_size = 1000U;
+  if (argc < 3) {
+    std::cerr << "Usage: ./memory_plan n n_samples [min_size] [max_size]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) min_size = std::stoi(argv[3]);
+    if (argc > 4) max_size = std::stoi(argv[4]);
+  }
+
+  mc::Analyzer analyzer(min_size, max_size);
+  const std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+
+  // Reductions are relative to the peak of the FLOP-optimal tree executed in
+  // its canonical order.
+  std::vector<double> reorder_saving, min_peak_saving, min_peak_penalty;
+  double front_size = 0.0;
+  for (const auto& k : S) {
+    const mc::Permutation perm = mc::exact(k);
+    const double peak = mc::peakMemory(perm, k);
+    const double reordered = mc::peakMemory(mc::minMemoryOrder(perm, k), k);
+    reorder_saving.push_back(peak > 0.0 ? 1.0 - reordered / peak : 0.0);
+
+    const std::vector<mc::MemoryPlan> front = mc::flopsMemoryFront(k);
+    front_size += front.size();
+    const mc::MemoryPlan plan = mc::planUnderMemory(k, front.back().peak_bytes);
+    min_peak_saving.push_back(peak > 0.0 ? 1.0 - plan.peak_bytes / peak : 0.0);
+    min_peak_penalty.push_back(mc::penalty(front.front().flops, plan.flops));
+  }
+
+  mc::printSavings(reorder_saving, "Peak saving, reordering the optimal tree:");
+  mc::printSavings(min_peak_saving, "Peak saving, least-peak tree:");
+  mc::printMetrics(min_peak_penalty, "FLOP penalty, least-peak tree:");
+  std::cout << "\navg Pareto front size: " << front_size / S.size() << "\n";
+}
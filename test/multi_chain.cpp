@@ -0,0 +1,62 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/multi_chain.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n_chains, trunk_length, tail_length, n_samples;
+  if (argc < 5) {
+    std::cerr << "Usage: ./multi_chain n_chains trunk_length tail_length "
+                 "n_samples\n";
+    exit(-1);
+  } else {
+    n_chains = std::stoi(argv[1]);
+    trunk_length = std::stoi(argv[2]);
+    tail_length = std::stoi(argv[3]);
+    n_samples = std::stoi(argv[4]);
+  }
+
+  // Every chain is a shared trunk T1...Tt followed by its own tail, which
+  // ends in a vector with probability 1/2 (as in A*B*C*x and A*B*C*y).
+  mc::Analyzer analyzer(1U, 1000U);
+  std::bernoulli_distribution ends_in_vector(0.5);
+  std::vector<double> saving(n_samples);
+  unsigned n_shared = 0U;
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance trunk = analyzer.randomInstance(trunk_length);
+    std::vector<mc::Factor> factors;
+    std::vector<std::string> trunk_names;
+    for (unsigned i = 0U; i < trunk_length; i++) {
+      trunk_names.push_back("T" + std::to_string(i));
+      factors.emplace_back(trunk_names.back(), trunk[i], trunk[i + 1U]);
+    }
+
+    std::vector<std::vector<std::string>> chains;
+    for (unsigned c = 0U; c < n_chains; c++) {
+      mc::Instance tail = analyzer.randomInstance(tail_length);
+      tail[0] = trunk.back();
+      if (ends_in_vector(analyzer.random_generator)) tail.back() = 1U;
+      chains.push_back(trunk_names);
+      for (unsigned i = 0U; i < tail_length; i++) {
+        const std::string name =
+            "X" + std::to_string(c) + "_" + std::to_string(i);
+        factors.emplace_back(name, tail[i], tail[i + 1U]);
+        chains.back().push_back(name);
+      }
+    }
+
+    const mc::MultiChainPlan plan = mc::planChains(factors, chains);
+    // No multiplication at all (single-factor chains) saves nothing.
+    saving[s] = (plan.independent_cost > 0.0)
+                    ? 1.0 - plan.cost / plan.independent_cost
+                    : 0.0;
+    if (plan.cost < plan.independent_cost) n_shared++;
+  }
+
+  mc::printSavings(saving, "Saving of the shared DAG:");
+  std::cout << "Instances with reuse: " << n_shared << " / " << n_samples
+            << "\n";
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/dyck.hpp"
+#include "../src/near_optimal.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples;
+  double epsilon;
+  if (argc < 4) {
+    std::cerr << "Usage: ./near_optimal n n_samples epsilon\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    epsilon = std::stod(argv[3]);
+  }
+
+  // Small chains are checked against the cost of every parenthesisation.
+  const bool check = n <= 14U;
+  std::vector<mc::DyckWord> words;
+  if (check) words = mc::generateDyckWords<mc::DyckWord>(n);
+
+  mc::Analyzer analyzer(1U, 1000U);
+  double seconds = 0.0, n_plans = 0.0;
+  unsigned n_incomplete = 0U, n_mismatches = 0U;
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance k = analyzer.randomInstance(n);
+    auto start = std::chrono::steady_clock::now();
+    const mc::NearOptimalPlans plans = mc::nearOptimalPlans(k, epsilon);
+    auto end = std::chrono::steady_clock::now();
+    seconds += std::chrono::duration<double>(end - start).count();
+    n_plans += plans.permutations.size();
+    if (!plans.complete) n_incomplete++;
+
+    if (!check) continue;
+    const double threshold = (1.0 + epsilon) * plans.optimal_cost;
+    std::size_t expected = 0U;
+    for (const auto& word : words)
+      if (mc::dyckFlops(word, k) <= threshold * (1.0 + 1e-12)) expected++;
+    bool match = expected == plans.permutations.size();
+    for (unsigned p = 0U; match and p < plans.permutations.size(); p++)
+      match = std::abs(mc::permutationFlops(plans.permutations[p], k) -
+                       plans.costs[p]) <= 1e-9 * plans.costs[p];
+    if (!match) n_mismatches++;
+  }
+  std::cout << "Average plans within " << epsilon
+            << " of the optimum: " << n_plans / n_samples
+            << "\nAverage time (ms): " << 1e3 * seconds / n_samples
+            << "\nIncomplete enumerations: " << n_incomplete << " / "
+            << n_samples << "\n";
+  if (check)
+    std::cout << "Mismatches with exhaustive enumeration: " << n_mismatches
+              << " / " << n_samples << "\n";
+}
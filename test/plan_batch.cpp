@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/plan_cache.hpp"
+
+// Input formats:
+//  * text: one chain per line, positive dimensions separated by blanks; '#'
+//    starts a comment up to the end of the line. Lines with fewer than two
+//    dimensions, a zero, a dimension above UINT_MAX or any other character
+//    are skipped with a message on the standard error.
+//  * binary: per chain, a uint32 with the number of dimensions followed by
+//    the dimensions as uint32 (native endianness). Chains with fewer than two
+//    dimensions or a zero are skipped with a message.
+// Output, one record per chain, in input order:
+//  * text: "cost<TAB>p1 p2 ... p(n-1)\n".
+//  * binary: uint32 number of entries of the permutation, double cost, then
+//    the permutation as uint32.
+
+namespace {
+
+constexpr std::size_t io_buffer_size = 1U << 22;
+constexpr std::uint32_t binary_piece = 1U << 16;  // Dimensions per read.
+
+struct Batch {  // Chains stored back to back.
+  std::vector<unsigned> dims;
+  std::vector<std::size_t> offsets{0U};  // Chain c is [offsets[c], [c+1]).
+
+  std::size_t size() const { return offsets.size() - 1U; }
+
+  void clear() {
+    dims.clear();
+    offsets.assign(1U, 0U);
+  }
+};
+
+class Reader {  // Parses chains straight out of a large read buffer.
+ private:
+  FILE* file;
+  bool binary;
+  std::vector<char> buffer;
+  std::size_t pos{0U}, end{0U};
+  unsigned long long line{0U};  // Lines read, in text mode.
+
+ public:
+  Reader(FILE* file, const bool binary)
+      : file{file}, binary{binary}, buffer(io_buffer_size) {}
+
+  // Appends the next chain to the batch. Returns false at end of input.
+  bool next(Batch& batch) {
+    return binary ? nextBinary(batch) : nextText(batch);
+  }
+
+ private:
+  bool refill() {
+    end = std::fread(buffer.data(), 1U, buffer.size(), file);
+    pos = 0U;
+    return end > 0U;
+  }
+
+  bool nextText(Batch& batch) {
+    constexpr unsigned max_dim = std::numeric_limits<unsigned>::max();
+    const std::size_t start = batch.dims.size();
+    unsigned value = 0U;
+    bool in_number = false, comment = false;
+    const char* error = nullptr;  // Why the current line is rejected.
+    auto endNumber = [&]() {
+      if (!in_number) return;
+      if (value == 0U and error == nullptr) error = "zero dimension";
+      batch.dims.push_back(value);
+      in_number = false;
+    };
+    while (true) {
+      const bool eof = (pos == end and !refill());
+      const char c = eof ? '\n' : buffer[pos++];
+      if (c == '\n') {
+        endNumber();
+        line++;
+        const std::size_t n_dims = batch.dims.size() - start;
+        if (error == nullptr and n_dims >= 2U) {
+          batch.offsets.push_back(batch.dims.size());
+          return true;
+        }
+        if (error == nullptr and n_dims == 1U) error = "single dimension";
+        if (error != nullptr)
+          std::cerr << "Skipping line " << line << ": " << error << "\n";
+        batch.dims.resize(start);
+        comment = false;
+        error = nullptr;
+        if (eof) return false;
+      } else if (comment or error != nullptr) {
+        continue;
+      } else if (c >= '0' and c <= '9') {
+        const unsigned digit = c - '0';
+        if (in_number and value > (max_dim - digit) / 10U)
+          error = "dimension out of range";
+        value = in_number ? value * 10U + digit : digit;
+        in_number = true;
+      } else if (c == '#') {
+        endNumber();
+        comment = true;
+      } else if (c == ' ' or c == '\t' or c == '\r') {
+        endNumber();
+      } else {
+        error = "not a dimension";
+      }
+    }
+  }
+
+  bool read(void* dst, std::size_t bytes) {
+    char* out = static_cast<char*>(dst);
+    while (bytes > 0U) {
+      if (pos == end and !refill()) return false;
+      const std::size_t chunk = std::min(bytes, end - pos);
+      std::memcpy(out, buffer.data() + pos, chunk);
+      pos += chunk;
+      out += chunk;
+      bytes -= chunk;
+    }
+    return true;
+  }
+
+  bool nextBinary(Batch& batch) {
+    const std::size_t start = batch.dims.size();
+    std::uint32_t n_dims = 0U;
+    while (n_dims < 2U) {
+      if (!read(&n_dims, sizeof(n_dims))) return false;
+      // The count is untrusted: grow by pieces, only as dimensions arrive.
+      for (std::uint32_t done = 0U; done < n_dims;) {
+        const std::uint32_t piece = std::min(n_dims - done, binary_piece);
+        batch.dims.resize(start + done + piece);
+        if (!read(batch.dims.data() + start + done, piece * sizeof(unsigned))) {
+          std::cerr << "Truncated binary input\n";
+          batch.dims.resize(start);
+          return false;
+        }
+        done += piece;
+      }
+      if (n_dims < 2U or
+          std::count(batch.dims.begin() + start, batch.dims.end(), 0U) > 0) {
+        std::cerr << "Skipping chain with fewer than two dimensions or a "
+                     "zero dimension\n";
+        batch.dims.resize(start);
+        n_dims = 0U;
+      }
+    }
+    batch.offsets.push_back(batch.dims.size());
+    return true;
+  }
+};
+
+void appendText(std::string& out, const double cost,
+                const mc::Permutation& perm) {
+  char digits[32];
+  auto res = std::to_chars(digits, digits + sizeof(digits), cost);
+  out.append(digits, res.ptr);
+  out.push_back('\t');
+  for (unsigned i = 0U; i < perm.size(); i++) {
+    if (i) out.push_back(' ');
+    res = std::to_chars(digits, digits + sizeof(digits), perm[i]);
+    out.append(digits, res.ptr);
+  }
+  out.push_back('\n');
+}
+
+void appendBinary(std::string& out, const double cost,
+                  const mc::Permutation& perm) {
+  const std::uint32_t size = perm.size();
+  out.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  out.append(reinterpret_cast<const char*>(&cost), sizeof(cost));
+  out.append(reinterpret_cast<const char*>(perm.data()),
+             perm.size() * sizeof(unsigned));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string algorithm = "reduceMin", input = "-";
+  unsigned n_threads = std::max(1U, std::thread::hardware_concurrency());
+  unsigned batch_size = 1U << 14;
+  std::size_t cache_bytes = 0U;
+  bool binary = false;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-b") {
+      binary = true;
+    } else if (i + 1 < argc and arg == "-a") {
+      algorithm = argv[++i];
+    } else if (i + 1 < argc and arg == "-i") {
+      input = argv[++i];
+    } else if (i + 1 < argc and arg == "-t") {
+      n_threads = std::max(1, std::stoi(argv[++i]));
+    } else if (i + 1 < argc and arg == "-n") {
+      batch_size = std::max(1, std::stoi(argv[++i]));
+    } else if (i + 1 < argc and arg == "-c") {
+      cache_bytes = std::stoull(argv[++i]) << 20;
+    } else {
+      std::cerr << "Usage: ./plan_batch [-a chandra|chin|huShing|reduceMin|"
+                   "reduceMinPolished|exact] "
+                   "[-i file] [-b] [-t n_threads] [-n batch_size] "
+                   "[-c cache_MiB]\n";
+      exit(-1);
+    }
+  }
+
+  std::function<mc::Permutation(const mc::Instance&)> solver;
+  if (algorithm == "chandra") {
+    solver = mc::chandra;
+  } else if (algorithm == "chin") {
+    solver = mc::chin;
+  } else if (algorithm == "huShing") {
+    solver = mc::huShing;
+  } else if (algorithm == "reduceMin") {
+    solver = mc::reduceMin;
+  } else if (algorithm == "reduceMinPolished") {
+    solver = mc::reduceMinPolished;
+  } else if (algorithm == "exact") {
+    solver = mc::exact;
+  } else {
+    std::cerr << "Unknown algorithm: " << algorithm << "\n";
+    exit(-1);
+  }
+
+  std::unique_ptr<mc::PlanCache> cache;
+  if (cache_bytes > 0U)
+    cache = std::make_unique<mc::PlanCache>(solver, cache_bytes);
+
+  FILE* in = (input == "-") ? stdin : std::fopen(input.c_str(), "rb");
+  if (in == nullptr) {
+    std::cerr << "Cannot open " << input << "\n";
+    exit(-1);
+  }
+  std::vector<char> out_buffer(io_buffer_size);
+  std::setvbuf(stdout, out_buffer.data(), _IOFBF, out_buffer.size());
+
+  Reader reader(in, binary);
+  Batch batch;
+  std::vector<std::string> outputs(n_threads);
+
+  // Plans chains [first, last) of the batch into out.
+  auto work = [&](const std::size_t first, const std::size_t last,
+                  std::string& out) {
+    out.clear();
+    for (std::size_t c = first; c < last; c++) {
+      const mc::Instance k(batch.dims.begin() + batch.offsets[c],
+                           batch.dims.begin() + batch.offsets[c + 1U]);
+      mc::Permutation perm;
+      double cost;
+      if (k.size() == 2U) {  // A single matrix: nothing to multiply.
+        cost = 0.0;
+      } else if (cache) {
+        mc::CachedPlan plan = cache->plan(k);
+        perm = std::move(plan.permutation);
+        cost = plan.cost;
+      } else {
+        perm = solver(k);
+        cost = mc::permutationFlops(perm, k);
+      }
+      if (binary)
+        appendBinary(out, cost, perm);
+      else
+        appendText(out, cost, perm);
+    }
+  };
+
+  bool more = true;
+  std::size_t n_chains = 0U;
+  while (more) {
+    batch.clear();
+    while (batch.size() < batch_size and (more = reader.next(batch))) {
+    }
+    if (batch.size() == 0U) break;
+    n_chains += batch.size();
+
+    // Contiguous slices keep the output of every thread in input order.
+    const std::size_t per_thread = (batch.size() + n_threads - 1U) / n_threads;
+    std::vector<std::thread> workers;
+    for (unsigned t = 1U; t < n_threads and t * per_thread < batch.size();
+         t++) {
+      const std::size_t last = std::min(batch.size(), (t + 1U) * per_thread);
+      workers.emplace_back(work, t * per_thread, last, std::ref(outputs[t]));
+    }
+    work(0U, std::min(batch.size(), per_thread), outputs[0]);
+    for (auto& worker : workers) worker.join();
+
+    for (unsigned t = 0U; t <= workers.size(); t++)
+      std::fwrite(outputs[t].data(), 1U, outputs[t].size(), stdout);
+  }
+  std::fflush(stdout);
+  if (in != stdin) std::fclose(in);
+
+  std::cerr << "Planned " << n_chains << " chains with " << algorithm;
+  if (cache)
+    std::cerr << " (cache hits: " << cache->hits()
+              << ", misses: " << cache->misses() << ")";
+  std::cerr << "\n";
+}
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/plan_cache.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_shapes, n_threads = 4U, n_queries = 100000U;
+  if (argc < 3) {
+    std::cerr << "Usage: ./plan_cache n n_shapes [n_threads] [n_queries]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_shapes = std::stoi(argv[2]);
+    if (argc > 3) n_threads = std::max(1, std::stoi(argv[3]));
+    if (argc > 4) n_queries = std::stoi(argv[4]);
+  }
+
+  mc::Analyzer analyzer(1U, 1000U);
+  const std::vector<mc::Instance> S = analyzer.randomInstances(n, n_shapes);
+  bool ok = true;
+
+  // Memory budget and eviction: a cache fitting about a tenth of the shapes
+  // stays within its budget and keeps the most recently used ones.
+  mc::PlanCache probe(mc::reduceMin, ~std::size_t{0}, 1U);
+  probe.plan(S.front());
+  const std::size_t budget = probe.memoryUsage() * (n_shapes / 10U + 1U);
+  mc::PlanCache small(mc::reduceMin, budget, 1U);
+  std::size_t max_usage = 0U;
+  for (const auto& k : S) {
+    small.plan(k);
+    max_usage = std::max(max_usage, small.memoryUsage());
+  }
+  mc::CachedPlan plan;
+  const bool last_kept = small.lookup(S.back(), plan);
+  const bool first_kept = n_shapes > small.size() and small.lookup(S[0], plan);
+  std::cout << "Budget (bytes): " << budget << "\nPeak usage (bytes): "
+            << max_usage << "\nEntries kept: " << small.size() << " of "
+            << n_shapes << "\n";
+  ok = ok and max_usage <= budget and last_kept and !first_kept;
+
+  // Normalisation: uniformly scaled shapes share an entry, and its cost is
+  // scaled by the cube of the factor.
+  mc::PlanCache normalized(mc::reduceMin, budget, 1U, true);
+  unsigned n_scaled_hits = 0U;
+  for (unsigned i = 0U; i < std::min(n_shapes, 100U); i++) {
+    mc::Instance scaled(S[i]);
+    for (auto& k : scaled) k *= 7U;
+    normalized.plan(S[i]);
+    const std::uint64_t hits = normalized.hits();
+    const mc::CachedPlan p = normalized.plan(scaled);
+    const double flops = mc::permutationFlops(p.permutation, scaled);
+    if (normalized.hits() == hits + 1U and p.cost == flops) n_scaled_hits++;
+  }
+  std::cout << "Scaled shapes hitting their entry: " << n_scaled_hits << " of "
+            << std::min(n_shapes, 100U) << "\n";
+  ok = ok and n_scaled_hits == std::min(n_shapes, 100U);
+
+  // Concurrent access: every thread queries the shapes in its own order;
+  // every plan must match its instance and every query be counted once. The
+  // budget fits all shapes, so misses are mostly first queries and races.
+  const std::size_t shared_budget = probe.memoryUsage() * 2U * n_shapes;
+  mc::PlanCache shared(mc::reduceMin, shared_budget);
+  std::atomic<unsigned> n_wrong{0U};
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned t = 0U; t < n_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (unsigned q = 0U; q < n_queries; q++) {
+        const mc::Instance& k = S[(q * (2U * t + 1U)) % n_shapes];
+        const mc::CachedPlan p = shared.plan(k);
+        if (p.cost != mc::permutationFlops(p.permutation, k)) n_wrong++;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  auto end = std::chrono::steady_clock::now();
+  const double total = static_cast<double>(n_threads) * n_queries;
+  std::cout << "Threads: " << n_threads << "\nQueries per second: "
+            << total / std::chrono::duration<double>(end - start).count()
+            << "\nHit rate: " << shared.hits() / total
+            << "\nWrong plans: " << n_wrong.load() << "\n";
+  ok = ok and n_wrong.load() == 0U and
+       shared.hits() + shared.misses() == total and
+       shared.memoryUsage() <= shared_budget;
+
+  try {  // A cache needs at least one shard.
+    mc::PlanCache none(mc::reduceMin, budget, 0U);
+    ok = false;
+  } catch (const std::invalid_argument&) {
+  }
+
+  std::cout << (ok ? "All checks passed\n" : "Some checks failed\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/plan_table.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_buckets, n_samples, lo = 1U, hi = 1000U;
+  std::string path;
+  if (argc < 4) {
+    std::cerr << "Usage: ./plan_table n n_buckets n_samples [lo] [hi] "
+                 "[table_file]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_buckets = std::stoi(argv[2]);
+    n_samples = std::stoi(argv[3]);
+    if (argc > 4) lo = std::stoi(argv[4]);
+    if (argc > 5) hi = std::stoi(argv[5]);
+    if (argc > 6) path = argv[6];
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  mc::PlanTable table = mc::PlanTable::build(n, lo, hi, n_buckets);
+  auto end = std::chrono::steady_clock::now();
+  std::cout << "Build time (s): "
+            << std::chrono::duration<double>(end - start).count() << "\n";
+  if (!path.empty()) {  // Round trip through the file.
+    table.save(path);
+    table = mc::PlanTable::load(path);
+  }
+  std::cout << "Cells: " << table.getNumCells()
+            << "\nRuns: " << table.getNumRuns()
+            << "\nDistinct plans: " << table.getPerms().size()
+            << "\nBytes: " << table.memoryUsage()
+            << "\nPenalty bound: " << table.getPenaltyBound() << "\n\n";
+
+  mc::Analyzer analyzer(lo, hi);
+  const std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+  std::vector<const mc::Permutation*> plans(S.size());
+  start = std::chrono::steady_clock::now();
+  for (unsigned j = 0U; j < S.size(); j++) plans[j] = &table.lookup(S[j]);
+  end = std::chrono::steady_clock::now();
+  std::cout << "Lookup (ns/plan): "
+            << std::chrono::duration<double, std::nano>(end - start).count() /
+                   S.size()
+            << "\n\n";
+
+  std::vector<double> penalties(S.size());
+  for (unsigned j = 0U; j < S.size(); j++)
+    penalties[j] = mc::penalty(mc::exactCost(S[j]),
+                               mc::permutationFlops(*plans[j], S[j]));
+  mc::printMetrics(penalties, "Plan table:");
+  const double max_penalty =
+      *std::max_element(penalties.begin(), penalties.end());
+  std::cout << "\nWithin bound: "
+            << (max_penalty <= table.getPenaltyBound() + 1e-12 ? "yes" : "no")
+            << "\n";
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/planner.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n_samples, max_n = 32U;
+  unsigned exact_threshold = mc::Planner::default_exact_threshold;
+  if (argc < 2) {
+    std::cerr << "Usage: ./planner_latency n_samples [max_n] "
+                 "[exact_threshold]\n";
+    exit(-1);
+  } else {
+    n_samples = std::stoi(argv[1]);
+    if (argc > 2) max_n = std::stoi(argv[2]);
+    if (argc > 3) exact_threshold = std::stoi(argv[3]);
+  }
+
+  mc::Analyzer analyzer(1U, 1000U);
+  mc::Planner planner(max_n, exact_threshold);
+  std::vector<mc::Step> schedule(max_n);
+
+  std::cout << "n\tmethod\tns/plan\tavg_penalty\tmax_penalty\n";
+  for (unsigned n = 2U; n <= max_n; n++) {
+    std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+
+    std::vector<double> cost_plan(S.size());
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned j = 0U; j < S.size(); j++)
+      cost_plan[j] = planner.plan(S[j].data(), S[j].size(), schedule.data());
+    auto end = std::chrono::steady_clock::now();
+    const double ns =
+        std::chrono::duration<double, std::nano>(end - start).count() /
+        S.size();
+
+    double avg_penalty = 0.0, max_penalty = 0.0;
+    for (unsigned j = 0U; j < S.size(); j++) {
+      const double p = mc::penalty(mc::exactCost(S[j]), cost_plan[j]);
+      avg_penalty += p;
+      max_penalty = std::max(max_penalty, p);
+    }
+
+    std::cout << n << '\t'
+              << (n <= planner.getExactThreshold() ? "exact" : "reduceMin")
+              << '\t' << ns << '\t' << avg_penalty / S.size() << '\t'
+              << max_penalty << '\n';
+  }
+}
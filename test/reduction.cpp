@@ -0,0 +1,51 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/reduction.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples, max_k = 1000U;
+  if (argc < 3) {
+    std::cerr << "Usage: ./reduction n n_samples [max_k]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) max_k = std::stoi(argv[3]);
+  }
+
+  mc::Analyzer analyzer(1U, max_k);
+  double reduced_length = 0.0, exact_seconds = 0.0, reduced_seconds = 0.0;
+  unsigned n_mismatches = 0U;
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance k = analyzer.randomInstance(n);
+    reduced_length += mc::reduceChain(k).reduced.size() - 1U;
+
+    auto start = std::chrono::steady_clock::now();
+    const mc::Permutation optimal = mc::exact(k);
+    auto end = std::chrono::steady_clock::now();
+    exact_seconds += std::chrono::duration<double>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    const mc::Permutation reduced = mc::reducedExact(k);
+    end = std::chrono::steady_clock::now();
+    reduced_seconds += std::chrono::duration<double>(end - start).count();
+
+    const double cost = mc::permutationFlops(optimal, k);
+    if (std::abs(mc::permutationFlops(reduced, k) - cost) > 1e-9 * cost)
+      n_mismatches++;
+  }
+  std::cout << "Average length of the reduced chain: "
+            << reduced_length / n_samples << " / " << n
+            << "\nAverage time of the exact DP (ms): "
+            << 1e3 * exact_seconds / n_samples
+            << "\nAverage time of the DP on the reduced chain (ms): "
+            << 1e3 * reduced_seconds / n_samples
+            << "\nSub-optimal plans: " << n_mismatches << " / " << n_samples
+            << "\n";
+}
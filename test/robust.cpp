@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/definitions.hpp"
+#include "../src/robust.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_uncertain, n_samples, max_batch = 4096U;
+  if (argc < 4) {
+    std::cerr << "Usage: ./robust n n_uncertain n_samples [max_batch]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_uncertain = std::min<unsigned>(std::stoi(argv[2]), n + 1U);
+    n_samples = std::stoi(argv[3]);
+    if (argc > 4) max_batch = std::stoi(argv[4]);
+  }
+
+  // Known dimensions are drawn in [1, 1000]; n_uncertain of them, chosen at
+  // random, are only known to be in [1, max_batch].
+  mc::Analyzer analyzer(1U, 1000U);
+  std::vector<unsigned> positions(n + 1U);
+  std::iota(positions.begin(), positions.end(), 0U);
+
+  const std::vector<std::pair<mc::RobustObjective, const char*>> objectives = {
+      {mc::RobustObjective::WorstCost, "Min worst cost:"},
+      {mc::RobustObjective::ExpectedCost, "Min expected cost:"},
+      {mc::RobustObjective::WorstPenalty, "Min worst penalty:"}};
+
+  // Per objective, the worst penalty across the vertices of every instance.
+  std::vector<std::vector<double>> worst_penalty(objectives.size());
+  std::vector<double> n_candidates(objectives.size(), 0.0);
+  for (unsigned s = 0U; s < n_samples; s++) {
+    const mc::Instance k = analyzer.randomInstance(n);
+    std::vector<mc::DimensionRange> ranges;
+    for (const auto& d : k) ranges.emplace_back(d, d);
+    std::shuffle(positions.begin(), positions.end(), analyzer.random_generator);
+    for (unsigned u = 0U; u < n_uncertain; u++)
+      ranges[positions[u]] = mc::DimensionRange(1U, max_batch);
+
+    for (unsigned o = 0U; o < objectives.size(); o++) {
+      const mc::RobustPlan plan = mc::robustPlan(ranges, objectives[o].first);
+      worst_penalty[o].push_back(plan.worst_penalty);
+      n_candidates[o] += plan.n_candidates;
+    }
+  }
+
+  // A penalty here is the worst case, across the vertices of the box, of the
+  // ratio with each vertex's own optimum.
+  for (unsigned o = 0U; o < objectives.size(); o++) {
+    mc::printMetrics(worst_penalty[o], objectives[o].second);
+    std::cout << "avg candidates: " << n_candidates[o] / n_samples << "\n\n";
+  }
+}
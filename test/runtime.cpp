@@ -0,0 +1,66 @@
+#include <iostream>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/generator.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples, n_reps = 3U, n_threads = 0U, max_size = 300U;
+  if (argc < 3) {
+    std::cerr << "Usage: ./runtime n n_samples [n_reps] [n_threads] "
+                 "[max_size]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) n_reps = std::stoi(argv[3]);
+    if (argc > 4) n_threads = std::stoi(argv[4]);
+    if (argc > 5) max_size = std::stoi(argv[5]);
+  }
+
+  auto A = mc::generateAlgorithms(n);
+  mc::Analyzer analyzer(1U, max_size);
+  std::vector<mc::Instance> S = analyzer.randomInstances(n, n_samples);
+
+  const unsigned M = A.size();
+  const unsigned N = S.size();
+  std::cout << "M: " << M << "\n";
+  std::cout << "N: " << N << "\n";
+
+  auto cost_matrix = mc::FLOPsOnInstances(A, S);
+  auto time_matrix = mc::TimesOnInstances(A, S, n_reps, n_threads);
+  auto perm2index = mc::getMapPerm2Index(A);
+
+  // Penalties are measured against the fastest parenthesisation.
+  auto min_T = mc::getMinA(M, N, time_matrix);
+
+  // FLOP-optimal
+  auto argmin_flops = mc::getArgMinA(M, N, cost_matrix);
+  auto time_flops = mc::getCostFromIDs(M, N, time_matrix, argmin_flops);
+  auto penalty_flops = mc::getPenaltyZ(N, min_T, time_flops);
+  mc::printMetrics(penalty_flops, "FLOP-optimal (time):");
+
+  using AlgMCP = std::function<mc::Permutation(const mc::Instance&)>;
+
+  // Chandra's
+  AlgMCP chandra = mc::chandra;
+  auto time_chandra =
+      mc::getCostFromApprx(A, S, time_matrix, perm2index, chandra);
+  auto penalty_chandra = mc::getPenaltyZ(N, min_T, time_chandra);
+  mc::printMetrics(penalty_chandra, "Chandra's (time):");
+
+  // Chin's
+  AlgMCP chin = mc::chin;
+  auto time_chin = mc::getCostFromApprx(A, S, time_matrix, perm2index, chin);
+  auto penalty_chin = mc::getPenaltyZ(N, min_T, time_chin);
+  mc::printMetrics(penalty_chin, "Chin's (time):");
+
+  // Reduce and minimize
+  AlgMCP rnm = mc::reduceMin;
+  auto time_rnm = mc::getCostFromApprx(A, S, time_matrix, perm2index, rnm);
+  auto penalty_rnm = mc::getPenaltyZ(N, min_T, time_rnm);
+  mc::printMetrics(penalty_rnm, "Algorithm 3 (time):");
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/algorithm.hpp"
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/apprx_registry.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/generator.hpp"
+
+int main(int argc, char** argv) {
+  unsigned max_n = 10'000'000U, n_reps = 3U, exact_max_n = 1'000U;
+  if (argc > 4) {
+    std::cerr << "Usage: ./scaling [max_n] [n_reps] [exact_max_n]\n";
+    exit(-1);
+  } else {
+    if (argc > 1) max_n = std::stoi(argv[1]);
+    if (argc > 2) n_reps = std::max(1, std::stoi(argv[2]));
+    if (argc > 3) exact_max_n = std::stoi(argv[3]);
+  }
+
+  // Every registered approximation that runs on chains of any length.
+  using AlgMCP = std::function<mc::Permutation(const mc::Instance&)>;
+  std::vector<std::pair<std::string, AlgMCP>> algorithms;
+  for (const auto& apprx : mc::getApproximations())
+    if (apprx.has(mc::apprx_any_length))
+      algorithms.push_back({apprx.name, apprx.solve});
+  algorithms.push_back({"minEssential", [](const mc::Instance& k) {
+                          return mc::getEssentialPerm(k.size() - 1U,
+                                                      mc::minEssential(k));
+                        }});
+
+  mc::Analyzer analyzer(1U, 1000U);
+
+  // Best of n_reps runs of f, in ns per factor of the chain.
+  auto time = [n_reps](const unsigned n, const std::function<void()>& f) {
+    double best = std::numeric_limits<double>::max();
+    for (unsigned r = 0U; r < n_reps; r++) {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      auto end = std::chrono::steady_clock::now();
+      best = std::min(
+          best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best / n;
+  };
+
+  std::cout << "n\tmethod\tns/factor\tpenalty\n";
+  for (unsigned long long n = 100U; n <= max_n; n *= 10U) {
+    const mc::Instance k = analyzer.randomInstance(n);
+
+    double optimum = 0.0;
+    if (n <= exact_max_n) {
+      mc::Permutation perm;
+      const double ns = time(n, [&]() { perm = mc::exact(k); });
+      optimum = mc::permutationFlops(perm, k);
+      std::cout << n << "\texact\t" << ns << "\t0\n";
+    }
+
+    for (const auto& [name, algorithm] : algorithms) {
+      mc::Permutation perm;
+      const double ns = time(n, [&]() { perm = algorithm(k); });
+      const double cost = mc::permutationFlops(perm, k);
+
+      std::cout << n << '\t' << name << '\t' << ns << '\t';
+      if (n <= exact_max_n)
+        std::cout << mc::penalty(optimum, cost) << '\n';
+      else
+        std::cout << "-\n";
+
+      if (name == "reduceMin") {  // Cost of evaluating a plan, for reference.
+        double flops = 0.0;
+        const double ns_cost =
+            time(n, [&]() { flops += mc::permutationFlops(perm, k); });
+        std::cout << n << "\tpermutationFlops\t" << ns_cost << "\t-\n";
+      }
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/sparse.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples;
+  double p_sparse = 0.5;
+  if (argc < 3) {
+    std::cerr << "Usage: ./sparse n n_samples [p_sparse]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) p_sparse = std::stod(argv[3]);
+  }
+
+  // Every factor is sparse with probability p_sparse, with a density drawn
+  // log-uniformly in [1e-4, 1e-1]; the others are dense.
+  mc::Analyzer analyzer(1U, 1000U);
+  std::bernoulli_distribution is_sparse(p_sparse);
+  std::uniform_real_distribution<double> log_density(-4.0, -1.0);
+  std::vector<mc::SparseInstance> S;
+  S.reserve(n_samples);
+  for (unsigned j = 0U; j < n_samples; j++) {
+    std::vector<double> densities(n, 1.0);
+    for (auto& d : densities) {
+      if (is_sparse(analyzer.random_generator))
+        d = std::pow(10.0, log_density(analyzer.random_generator));
+    }
+    S.emplace_back(analyzer.randomInstance(n), densities);
+  }
+
+  const unsigned N = S.size();
+  std::vector<double> min_S(N), cost_dense(N), cost_rnm(N), cost_ess(N),
+      cost_srnm(N);
+  for (unsigned j = 0U; j < N; j++) {
+    min_S[j] = mc::sparseCost(mc::sparseExact(S[j]), S[j]);
+    cost_dense[j] = mc::sparseCost(mc::exact(S[j].dims), S[j]);
+    cost_rnm[j] = mc::sparseCost(mc::reduceMin(S[j].dims), S[j]);
+    cost_ess[j] = mc::sparseCost(mc::sparseMinEssential(S[j]), S[j]);
+    cost_srnm[j] = mc::sparseCost(mc::sparseReduceMin(S[j]), S[j]);
+  }
+
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_dense),
+                   "Dense-optimal order (sparse cost):");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_rnm),
+                   "Algorithm 3 on dimensions (sparse cost):");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_ess), "Sparse essentials:");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_srnm),
+                   "Sparse Algorithm 3:");
+}
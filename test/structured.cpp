@@ -0,0 +1,63 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../src/analyzer.hpp"
+#include "../src/apprx_algorithms.hpp"
+#include "../src/definitions.hpp"
+#include "../src/exact.hpp"
+#include "../src/structured.hpp"
+
+int main(int argc, char** argv) {
+  unsigned n, n_samples;
+  double p_structured = 0.5;
+  if (argc < 3) {
+    std::cerr << "Usage: ./structured n n_samples [p_structured]\n";
+    exit(-1);
+  } else {
+    n = std::stoi(argv[1]);
+    n_samples = std::stoi(argv[2]);
+    if (argc > 3) p_structured = std::stod(argv[3]);
+  }
+
+  // Every factor is structured with probability p_structured, in which case
+  // it is made square and gets a random structure and transposition.
+  mc::Analyzer analyzer(1U, 1000U);
+  std::bernoulli_distribution is_structured(p_structured), coin(0.5);
+  std::uniform_int_distribution<int> pick(1, 4);
+  std::vector<mc::StructuredInstance> S;
+  S.reserve(n_samples);
+  for (unsigned j = 0U; j < n_samples; j++) {
+    mc::Instance dims = analyzer.randomInstance(n);
+    std::vector<mc::Operand> operands(n);
+    for (unsigned i = 0U; i < n; i++) {
+      if (is_structured(analyzer.random_generator)) {
+        dims[i + 1U] = dims[i];
+        operands[i] = {static_cast<mc::Structure>(
+                           pick(analyzer.random_generator)),
+                       coin(analyzer.random_generator)};
+      }
+    }
+    S.emplace_back(dims, operands);
+  }
+
+  const unsigned N = S.size();
+  std::vector<double> min_S(N), cost_dense(N), cost_rnm(N), cost_srnm(N),
+      cost_ess(N);
+  for (unsigned j = 0U; j < N; j++) {
+    min_S[j] = mc::structuredCost(mc::structuredExact(S[j]), S[j]);
+    cost_dense[j] = mc::structuredCost(mc::exact(S[j].dims), S[j]);
+    cost_rnm[j] = mc::structuredCost(mc::reduceMin(S[j].dims), S[j]);
+    cost_ess[j] = mc::structuredCost(mc::structuredMinEssential(S[j]), S[j]);
+    cost_srnm[j] = mc::structuredCost(mc::structuredReduceMin(S[j]), S[j]);
+  }
+
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_dense),
+                   "Dense-optimal order (structured cost):");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_rnm),
+                   "Algorithm 3 on dimensions (structured cost):");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_ess),
+                   "Structured essentials:");
+  mc::printMetrics(mc::getPenaltyZ(N, min_S, cost_srnm),
+                   "Structured Algorithm 3:");
+}